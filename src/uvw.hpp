@@ -1,11 +1,15 @@
+#include "uvw/allocator.h"
 #include "uvw/async.h"
+#include "uvw/buffer.h"
 #include "uvw/check.h"
 #include "uvw/config.h"
+#include "uvw/connector.h"
 #include "uvw/dns.h"
 #include "uvw/emitter.h"
 #include "uvw/fs.h"
 #include "uvw/fs_event.h"
 #include "uvw/fs_poll.h"
+#include "uvw/function.hpp"
 #include "uvw/handle.hpp"
 #include "uvw/idle.h"
 #include "uvw/lib.h"
@@ -16,8 +20,11 @@
 #include "uvw/process.h"
 #include "uvw/request.hpp"
 #include "uvw/resource.hpp"
+#include "uvw/server.h"
 #include "uvw/signal.h"
+#include "uvw/slab.h"
 #include "uvw/tcp.h"
+#include "uvw/tcp_pool.h"
 #include "uvw/thread.h"
 #include "uvw/timer.h"
 #include "uvw/tty.h"
@@ -0,0 +1,48 @@
+#ifdef UVW_AS_LIB
+#include "allocator.h"
+#endif
+
+#include <cstdlib>
+
+#include "config.h"
+
+
+namespace uvw {
+
+
+namespace details {
+
+
+UVW_INLINE Allocator & allocator() noexcept {
+    static Allocator current{
+        [](std::size_t size) { return std::malloc(size); },
+        [](void *ptr, std::size_t size) { return std::realloc(ptr, size); },
+        [](std::size_t count, std::size_t size) { return std::calloc(count, size); },
+        [](void *ptr) { std::free(ptr); }
+    };
+
+    return current;
+}
+
+
+UVW_INLINE void * allocate(std::size_t size) {
+    // zero-sized requests must still return unique pointers
+    if(auto *ptr = allocator().malloc(size ? size : 1u); ptr) {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+
+UVW_INLINE void deallocate(void *ptr) noexcept {
+    if(ptr) {
+        allocator().free(ptr);
+    }
+}
+
+
+}
+
+
+}
@@ -0,0 +1,169 @@
+#ifndef UVW_ALLOCATOR_INCLUDE_H
+#define UVW_ALLOCATOR_INCLUDE_H
+
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace uvw {
+
+
+/**
+ * @brief Memory allocation functions.
+ *
+ * A single set of functions serves both `uvw` and the underlying library, it
+ * defaults to the ones of the standard library.<br/>
+ * Within `uvw`, they serve resources, listeners and heap spilled targets of
+ * Function, the pools of buffers and slabs, the buffers for reading data and
+ * the internal state of streams and UDP handles (batches of writes and
+ * datagrams, batch accept, buffer arrays of vectored writes).
+ *
+ * The following allocations still use the global heap:
+ *
+ * * Containers exchanged with the user as `std::vector`s, that is the buffers
+ * of vectored writes (also those queued by a corked stream), the datagrams of
+ * `UDPHandle::sendBatch` and the handles of AcceptEvent events.
+ * * Setup and control objects that aren't on the hot paths: loops, servers,
+ * connection pools and connectors, the options of processes and the results
+ * of the functions of Utilities.
+ * * Over-aligned targets of Function.
+ *
+ * See `Utilities::replaceAllocator` for further details.
+ */
+struct Allocator {
+    using MallocFuncType = void*(*)(std::size_t);
+    using ReallocFuncType = void*(*)(void*, std::size_t);
+    using CallocFuncType = void*(*)(std::size_t, std::size_t);
+    using FreeFuncType = void(*)(void*);
+
+    MallocFuncType malloc; /*!< Replacement function for _malloc_. */
+    ReallocFuncType realloc; /*!< Replacement function for _realloc_. */
+    CallocFuncType calloc; /*!< Replacement function for _calloc_. */
+    FreeFuncType free; /*!< Replacement function for _free_. */
+};
+
+
+namespace details {
+
+
+Allocator & allocator() noexcept;
+void * allocate(std::size_t size);
+void deallocate(void *ptr) noexcept;
+
+
+/**
+ * @brief Standard allocator that draws from the allocation functions in use.
+ *
+ * Memory is suitably aligned for all the types whose alignment doesn't exceed
+ * that of `std::max_align_t`.
+ */
+template<typename T>
+struct AllocatorAdapter {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types aren't supported");
+
+    using value_type = T;
+
+    AllocatorAdapter() noexcept = default;
+
+    template<typename U>
+    AllocatorAdapter(const AllocatorAdapter<U> &) noexcept {}
+
+    T * allocate(std::size_t n) {
+        return static_cast<T *>(details::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, std::size_t) noexcept {
+        details::deallocate(ptr);
+    }
+
+    template<typename U>
+    bool operator==(const AllocatorAdapter<U> &) const noexcept {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const AllocatorAdapter<U> &) const noexcept {
+        return false;
+    }
+};
+
+
+/**
+ * @brief Deleter for the objects created with `allocateUnique`.
+ *
+ * Arrays are only supported for trivially destructible types.
+ */
+template<typename T>
+struct AllocatorDeleter {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types aren't supported");
+
+    void operator()(T *ptr) const noexcept {
+        ptr->~T();
+        details::deallocate(ptr);
+    }
+};
+
+
+template<typename T>
+struct AllocatorDeleter<T[]> {
+    static_assert(std::is_trivially_destructible_v<T>, "Arrays of non-trivial types aren't supported");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types aren't supported");
+
+    void operator()(T *ptr) const noexcept {
+        details::deallocate(ptr);
+    }
+};
+
+
+template<typename T>
+using AllocatorPtr = std::unique_ptr<T, AllocatorDeleter<T>>;
+
+
+/**
+ * @brief Creates an object with the allocation functions in use.
+ *
+ * It's the counterpart of `std::allocate_shared` with an `AllocatorAdapter`
+ * for unique pointers.
+ */
+template<typename T, typename... Args>
+std::enable_if_t<!std::is_array_v<T>, AllocatorPtr<T>> allocateUnique(Args&&... args) {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types aren't supported");
+    void *ptr = details::allocate(sizeof(T));
+
+    try {
+        return AllocatorPtr<T>{::new (ptr) T{std::forward<Args>(args)...}};
+    } catch(...) {
+        details::deallocate(ptr);
+        throw;
+    }
+}
+
+
+/**
+ * @brief Creates a value-initialized array with the allocation functions in
+ * use.
+ */
+template<typename T>
+std::enable_if_t<std::is_array_v<T>, AllocatorPtr<T>> allocateUnique(std::size_t count) {
+    using Type = std::remove_extent_t<T>;
+    auto *ptr = static_cast<Type *>(details::allocate(count * sizeof(Type)));
+    std::uninitialized_value_construct_n(ptr, count);
+    return AllocatorPtr<T>{ptr};
+}
+
+
+}
+
+
+}
+
+
+#ifndef UVW_AS_LIB
+#include "allocator.cpp"
+#endif
+
+#endif // UVW_ALLOCATOR_INCLUDE_H
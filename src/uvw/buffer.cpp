@@ -0,0 +1,194 @@
+#ifdef UVW_AS_LIB
+#include "buffer.h"
+#endif
+
+#include <new>
+#include <utility>
+
+#include "config.h"
+
+
+namespace uvw {
+
+
+UVW_INLINE BufferDeleter::BufferDeleter(std::default_delete<char[]>) noexcept
+    : BufferDeleter{}
+{}
+
+
+UVW_INLINE BufferDeleter::BufferDeleter(Fn *fn, void *data) noexcept
+    : func{fn}, payload{data}
+{}
+
+
+UVW_INLINE BufferDeleter BufferDeleter::heap() noexcept {
+    return BufferDeleter{[](char *ptr, void *) noexcept { details::deallocate(ptr); }, nullptr};
+}
+
+
+UVW_INLINE void BufferDeleter::operator()(char *ptr) const noexcept {
+    if(func) {
+        func(ptr, payload);
+    } else {
+        delete[] ptr;
+    }
+}
+
+
+UVW_INLINE void BufferDeleter::operator()(const char *ptr) const noexcept {
+    (*this)(const_cast<char *>(ptr));
+}
+
+
+UVW_INLINE Buffer::Buffer(std::unique_ptr<char[], BufferDeleter> ptr, unsigned int len) noexcept
+    : data{std::move(ptr)}, length{len}
+{}
+
+
+UVW_INLINE Buffer::Buffer(char *ptr, unsigned int len) noexcept
+    : data{ptr, BufferDeleter{[](char *, void *) noexcept {}, nullptr}}, length{len}
+{}
+
+
+UVW_INLINE void BufferPool::release(char *ptr, void *payload) noexcept {
+    auto *pool = static_cast<BufferPool *>(payload);
+    auto *chunk = reinterpret_cast<Chunk *>(ptr - OFFSET);
+
+    if(pool->detached.load(std::memory_order_acquire)) {
+        // the loop is gone, nobody is going to reuse the buffer
+        details::deallocate(chunk);
+    } else {
+        chunk->next = pool->returned.load(std::memory_order_relaxed);
+        while(!pool->returned.compare_exchange_weak(chunk->next, chunk, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // the last buffer to come back once the loop is gone takes the pool with it
+    if(pool->outstanding.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+        delete pool;
+    }
+}
+
+
+UVW_INLINE void BufferPool::dispose(Chunk *chunk) noexcept {
+    while(chunk) {
+        details::deallocate(std::exchange(chunk, chunk->next));
+    }
+}
+
+
+UVW_INLINE BufferPool::BufferPool(std::size_t value) noexcept
+    : max{value}
+{}
+
+
+UVW_INLINE BufferPool::~BufferPool() noexcept {
+    clear();
+}
+
+
+UVW_INLINE void BufferPool::reclaim() noexcept {
+    auto *chunk = returned.exchange(nullptr, std::memory_order_acquire);
+
+    while(chunk) {
+        auto *next = chunk->next;
+        info.used -= chunk->capacity;
+
+        if(chunk->index < CLASSES && info.pooled + chunk->capacity <= max) {
+            info.pooled += chunk->capacity;
+            chunk->next = std::exchange(free[chunk->index], chunk);
+        } else {
+            details::deallocate(chunk);
+        }
+
+        chunk = next;
+    }
+}
+
+
+UVW_INLINE BufferPool::Chunk * BufferPool::trim(std::size_t threshold) noexcept {
+    Chunk *chunks = nullptr;
+
+    // the largest buffers go first, the small ones are the most reusable
+    for(auto index = CLASSES; index && info.pooled > threshold; --index) {
+        while(free[index - 1u] && info.pooled > threshold) {
+            auto *chunk = std::exchange(free[index - 1u], free[index - 1u]->next);
+            info.pooled -= chunk->capacity;
+            chunk->next = std::exchange(chunks, chunk);
+        }
+    }
+
+    return chunks;
+}
+
+
+UVW_INLINE void BufferPool::detach() noexcept {
+    detached.store(true, std::memory_order_release);
+    clear();
+
+    // buffers still in use will take care of the pool, the loop holds a reference as well
+    if(outstanding.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+        delete this;
+    }
+}
+
+
+UVW_INLINE std::unique_ptr<char[], BufferDeleter> BufferPool::allocate(std::size_t size) {
+    std::size_t index = 0u;
+
+    if(returned.load(std::memory_order_relaxed)) {
+        reclaim();
+    }
+
+    while(index < CLASSES && (std::size_t{1u} << (MIN_SHIFT + index)) < size) {
+        ++index;
+    }
+
+    const auto capacity = index < CLASSES ? (std::size_t{1u} << (MIN_SHIFT + index)) : size;
+    Chunk *chunk = nullptr;
+
+    if(index < CLASSES && free[index]) {
+        chunk = std::exchange(free[index], free[index]->next);
+        info.pooled -= capacity;
+        ++info.hits;
+    } else {
+        chunk = new (details::allocate(OFFSET + capacity)) Chunk{nullptr, index, capacity};
+        ++info.misses;
+    }
+
+    info.used += capacity;
+    outstanding.fetch_add(1u, std::memory_order_relaxed);
+
+    return std::unique_ptr<char[], BufferDeleter>{reinterpret_cast<char *>(chunk) + OFFSET, deleter()};
+}
+
+
+UVW_INLINE BufferDeleter BufferPool::deleter() noexcept {
+    return BufferDeleter{&release, this};
+}
+
+
+UVW_INLINE void BufferPool::limit(std::size_t value) noexcept {
+    reclaim();
+    dispose(trim(value));
+    max = value;
+}
+
+
+UVW_INLINE std::size_t BufferPool::limit() const noexcept {
+    return max;
+}
+
+
+UVW_INLINE void BufferPool::clear() noexcept {
+    reclaim();
+    dispose(trim(0u));
+}
+
+
+UVW_INLINE BufferPool::Stats BufferPool::stats() noexcept {
+    reclaim();
+    return info;
+}
+
+
+}
@@ -0,0 +1,223 @@
+#ifndef UVW_BUFFER_INCLUDE_H
+#define UVW_BUFFER_INCLUDE_H
+
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include "allocator.h"
+#include "function.hpp"
+
+
+namespace uvw {
+
+
+/**
+ * @brief Deleter for the buffers handed out by `uvw`.
+ *
+ * Buffers can come from different sources (the global heap, the pool of a
+ * loop, a custom allocator) and each one of them knows how to give its memory
+ * back. A default constructed deleter releases memory with `delete[]`.<br/>
+ * It's implicitly constructible from `std::default_delete<char[]>`, therefore
+ * an `std::unique_ptr<char[]>` can be converted to an
+ * `std::unique_ptr<char[], BufferDeleter>` as usual.
+ */
+struct BufferDeleter {
+    using Fn = void(char *, void *) noexcept;
+
+    /*! @brief Default constructor, memory is released with `delete[]`. */
+    BufferDeleter() noexcept = default;
+
+    /*! @brief Memory is released with `delete[]`. */
+    BufferDeleter(std::default_delete<char[]>) noexcept;
+
+    /**
+     * @brief Constructs a deleter that invokes a given function.
+     * @param fn A function that releases a buffer.
+     * @param data An opaque pointer passed back to the function.
+     */
+    BufferDeleter(Fn *fn, void *data) noexcept;
+
+    /**
+     * @brief Gets a deleter for buffers obtained from the allocation functions
+     * in use.
+     * @return A deleter that gives the buffers back to the allocator.
+     */
+    static BufferDeleter heap() noexcept;
+
+    /**
+     * @brief Releases a buffer.
+     * @param ptr A pointer to the buffer to release.
+     */
+    void operator()(char *ptr) const noexcept;
+
+    /**
+     * @brief Releases a read-only buffer.
+     * @param ptr A pointer to the buffer to release.
+     */
+    void operator()(const char *ptr) const noexcept;
+
+private:
+    Fn *func{nullptr};
+    void *payload{nullptr};
+};
+
+
+/**
+ * @brief Chunk of data along with its length.
+ *
+ * Buffers either own their data, in which case the deleter takes care of it
+ * once the buffer isn't required anymore, or just refer to data the lifetime
+ * of which is in charge of the user.
+ */
+struct Buffer {
+    /**
+     * @brief Constructs a buffer that owns its data.
+     * @param ptr The data of the buffer.
+     * @param len The length of the data.
+     */
+    Buffer(std::unique_ptr<char[], BufferDeleter> ptr, unsigned int len) noexcept;
+
+    /**
+     * @brief Constructs a buffer that doesn't own its data.
+     * @param ptr The data of the buffer.
+     * @param len The length of the data.
+     */
+    Buffer(char *ptr, unsigned int len) noexcept;
+
+    std::unique_ptr<char[], BufferDeleter> data; /*!< The data of the buffer. */
+    unsigned int length; /*!< The length of the data. */
+};
+
+
+/**
+ * @brief Allocator used by handles to get the buffers to read into.
+ *
+ * It's invoked with the suggested size of the buffer and can change it to the
+ * actual size of the buffer it returns. Returning an empty buffer makes the
+ * read fail with `UV_ENOBUFS`.<br/>
+ * The deleter of the buffer is propagated to the event that carries the data.
+ */
+using BufferAllocator = Function<std::unique_ptr<char[], BufferDeleter>(std::size_t &)>;
+
+
+/**
+ * @brief Size-classed pool of buffers.
+ *
+ * Each loop owns a pool from which handles draw the buffers used to read data.
+ * Buffers are grouped by size in power of two classes, from 1 KiB to 64 KiB,
+ * and go back to the freelist of their class once released, as long as the
+ * pool doesn't exceed its limit. Larger requests are served directly from the
+ * heap.<br/>
+ * Buffers can be released from any thread and can outlive the loop that
+ * created them. Released buffers are queued without locks and go back to the
+ * freelists the next time the pool is used. Any other member function must be
+ * invoked from the thread that runs the loop.
+ */
+class BufferPool final {
+    friend class Loop;
+
+    struct Chunk {
+        Chunk *next;
+        std::size_t index;
+        std::size_t capacity;
+    };
+
+    static constexpr std::size_t ALIGN = alignof(std::max_align_t);
+    static constexpr std::size_t OFFSET = (sizeof(Chunk) + ALIGN - 1u) / ALIGN * ALIGN;
+    static constexpr std::size_t MIN_SHIFT = 10u;
+    static constexpr std::size_t MAX_SHIFT = 16u;
+    static constexpr std::size_t CLASSES = MAX_SHIFT - MIN_SHIFT + 1u;
+
+    static void release(char *ptr, void *payload) noexcept;
+    static void dispose(Chunk *chunk) noexcept;
+
+    explicit BufferPool(std::size_t value) noexcept;
+    ~BufferPool() noexcept;
+
+    void reclaim() noexcept;
+    Chunk * trim(std::size_t threshold) noexcept;
+    void detach() noexcept;
+
+public:
+    /*! @brief Statistics about the pool. */
+    struct Stats {
+        std::size_t pooled; /*!< Bytes kept in the freelists. */
+        std::size_t used; /*!< Bytes currently handed out. */
+        std::size_t hits; /*!< Requests served from the freelists. */
+        std::size_t misses; /*!< Requests that required an allocation. */
+    };
+
+    /*! @brief Default limit on pooled bytes. */
+    static constexpr std::size_t DEFAULT_LIMIT = 1024u * 1024u;
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool(BufferPool &&) = delete;
+
+    BufferPool & operator=(const BufferPool &) = delete;
+    BufferPool & operator=(BufferPool &&) = delete;
+
+    /**
+     * @brief Gets a buffer from the pool.
+     * @param size The minimum size of the buffer, in bytes.
+     * @return A buffer of at least the requested size.
+     */
+    std::unique_ptr<char[], BufferDeleter> allocate(std::size_t size);
+
+    /**
+     * @brief Gets the deleter to use with the buffers of the pool.
+     * @return A deleter that gives the buffers back to the pool.
+     */
+    BufferDeleter deleter() noexcept;
+
+    /**
+     * @brief Sets the maximum amount of bytes kept in the freelists.
+     *
+     * Idle buffers that exceed the new limit are released immediately.
+     *
+     * @param max The maximum amount of pooled bytes.
+     */
+    void limit(std::size_t max) noexcept;
+
+    /**
+     * @brief Gets the maximum amount of bytes kept in the freelists.
+     * @return The maximum amount of pooled bytes.
+     */
+    std::size_t limit() const noexcept;
+
+    /**
+     * @brief Releases all the idle buffers.
+     *
+     * Buffers currently in use aren't affected.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Gets the statistics of the pool.
+     *
+     * Buffers released in the meantime are taken back first.
+     *
+     * @return A snapshot of the statistics of the pool.
+     */
+    Stats stats() noexcept;
+
+private:
+    Chunk *free[CLASSES]{};
+    // buffers released and not yet taken back, from any thread
+    std::atomic<Chunk *> returned{nullptr};
+    std::size_t max;
+    // buffers in use plus one for the loop
+    std::atomic<std::size_t> outstanding{1u};
+    Stats info{};
+    std::atomic<bool> detached{false};
+};
+
+
+}
+
+
+#ifndef UVW_AS_LIB
+#include "buffer.cpp"
+#endif
+
+#endif // UVW_BUFFER_INCLUDE_H
@@ -0,0 +1,210 @@
+#ifdef UVW_AS_LIB
+#include "connector.h"
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "config.h"
+
+
+namespace uvw {
+
+
+UVW_INLINE void TCPConnector::order(const addrinfo *info) {
+    std::vector<sockaddr_storage> primary{};
+    std::vector<sockaddr_storage> secondary{};
+
+    for(auto *curr = info; curr; curr = curr->ai_next) {
+        if(curr->ai_family == AF_INET6 || curr->ai_family == AF_INET) {
+            sockaddr_storage storage{};
+            std::memcpy(&storage, curr->ai_addr, curr->ai_addrlen);
+            // the resolver sorts the addresses, the relative order is preserved
+            (curr->ai_family == AF_INET6 ? primary : secondary).push_back(storage);
+        }
+    }
+
+    candidates.clear();
+
+    for(std::size_t pos{}; pos < primary.size() || pos < secondary.size(); ++pos) {
+        if(pos < primary.size()) { candidates.push_back(primary[pos]); }
+        if(pos < secondary.size()) { candidates.push_back(secondary[pos]); }
+    }
+}
+
+
+UVW_INLINE void TCPConnector::next() {
+    timer->stop();
+
+    while(cursor < candidates.size()) {
+        auto handle = pLoop->resource<TCPHandle>();
+        const auto &addr = candidates[cursor++];
+
+        if(!handle) {
+            last = UV_ENOMEM;
+            continue;
+        }
+
+        handle->once<ConnectEvent>([this](const auto &, TCPHandle &conn) { win(conn); });
+        handle->once<ErrorEvent>([this](const ErrorEvent &event, TCPHandle &conn) { lose(event, conn); });
+        attempts.push_back(handle);
+
+        // attempts that fail on the spot don't start the following one
+        starting = true;
+        handle->connect(reinterpret_cast<const sockaddr &>(addr));
+        starting = false;
+
+        if(!handle->closing()) {
+            if(cursor < candidates.size()) {
+                timer->start(delay, Time{0});
+            }
+
+            return;
+        }
+    }
+
+    if(attempts.empty()) {
+        fail(last);
+    }
+}
+
+
+UVW_INLINE void TCPConnector::win(TCPHandle &handle) {
+    auto guard = std::move(self);
+    auto winner = handle.shared_from_this();
+
+    handle.clear();
+    attempts.erase(std::remove(attempts.begin(), attempts.end(), winner), attempts.end());
+    reset();
+
+    publish(ConnectorEvent{std::move(winner)});
+}
+
+
+UVW_INLINE void TCPConnector::lose(const ErrorEvent &event, TCPHandle &handle) {
+    auto ptr = handle.shared_from_this();
+
+    last = event.code();
+    handle.clear();
+    handle.close();
+    attempts.erase(std::remove(attempts.begin(), attempts.end(), ptr), attempts.end());
+
+    // a failed attempt starts the following one immediately
+    if(!starting) {
+        next();
+    }
+}
+
+
+UVW_INLINE void TCPConnector::fail(int err) {
+    auto guard = std::move(self);
+    reset();
+    publish(ErrorEvent{err});
+}
+
+
+UVW_INLINE void TCPConnector::reset() noexcept {
+    if(req) {
+        req->cancel();
+        req.reset();
+    }
+
+    for(auto &&handle: attempts) {
+        handle->clear();
+        handle->close();
+    }
+
+    if(timer) {
+        timer->stop();
+    }
+
+    attempts.clear();
+    candidates.clear();
+    cursor = 0u;
+}
+
+
+UVW_INLINE TCPConnector::TCPConnector(ConstructorAccess, std::shared_ptr<Loop> ref)
+    : pLoop{std::move(ref)}, self{}, req{}, timer{}, candidates{}, attempts{},
+      cursor{}, delay{DEFAULT_DELAY}, last{}, starting{}
+{}
+
+
+UVW_INLINE std::shared_ptr<TCPConnector> TCPConnector::create(std::shared_ptr<Loop> loop) {
+    return std::make_shared<TCPConnector>(ConstructorAccess{0}, std::move(loop));
+}
+
+
+UVW_INLINE TCPConnector::~TCPConnector() noexcept {
+    if(timer) {
+        timer->close();
+    }
+}
+
+
+UVW_INLINE void TCPConnector::connect(const std::string &host, unsigned int port) {
+    cancel();
+
+    if(!timer) {
+        timer = pLoop->resource<TimerHandle>();
+
+        if(!timer) {
+            publish(ErrorEvent{static_cast<int>(UV_ENOMEM)});
+            return;
+        }
+
+        timer->on<TimerEvent>([this](const auto &, auto &) { next(); });
+    }
+
+    req = pLoop->resource<GetAddrInfoReq>();
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+
+    // late results of a canceled resolution are ignored
+    req->on<ErrorEvent>([ref = weak_from_this()](const ErrorEvent &event, GetAddrInfoReq &curr) {
+        if(auto conn = ref.lock(); conn && conn->req.get() == &curr) {
+            conn->req.reset();
+            conn->fail(event.code());
+        }
+    });
+
+    req->on<AddrInfoEvent>([ref = weak_from_this()](const AddrInfoEvent &event, GetAddrInfoReq &curr) {
+        if(auto conn = ref.lock(); conn && conn->req.get() == &curr) {
+            conn->req.reset();
+            conn->order(event.data.get());
+            conn->last = UV_EAI_NONAME;
+            conn->next();
+        }
+    });
+
+    self = shared_from_this();
+    req->addrInfo(host, std::to_string(port), &hints);
+}
+
+
+UVW_INLINE void TCPConnector::attemptDelay(Time value) noexcept {
+    delay = value;
+}
+
+
+UVW_INLINE void TCPConnector::cancel() noexcept {
+    auto guard = std::move(self);
+    reset();
+}
+
+
+UVW_INLINE bool TCPConnector::pending() const noexcept {
+    return (self != nullptr);
+}
+
+
+UVW_INLINE Loop & TCPConnector::loop() const noexcept {
+    return *pLoop;
+}
+
+
+}
@@ -0,0 +1,138 @@
+#ifndef UVW_CONNECTOR_INCLUDE_H
+#define UVW_CONNECTOR_INCLUDE_H
+
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <uv.h>
+#include "dns.h"
+#include "emitter.h"
+#include "loop.h"
+#include "tcp.h"
+#include "timer.h"
+
+
+namespace uvw {
+
+
+/**
+ * @brief ConnectorEvent event.
+ *
+ * It will be emitted by TCPConnector according with its functionalities.
+ */
+struct ConnectorEvent {
+    std::shared_ptr<TCPHandle> handle; /*!< The connected handle. */
+};
+
+
+/**
+ * @brief Connects to hosts by name, the happy eyeballs way.
+ *
+ * The connector resolves the name of the host and tries the addresses in
+ * parallel, as described by RFC 8305: addresses are interleaved by family,
+ * IPv6 first, and a new attempt starts whenever the previous one fails or
+ * doesn't complete within the attempt delay. The first attempt that succeeds
+ * wins and all the others are closed.<br/>
+ * A blackholed address costs at most the attempt delay rather than a full
+ * connect timeout.
+ *
+ * A ConnectorEvent event will be emitted with the connected handle in case of
+ * success. An ErrorEvent event will be emitted in case of errors, with the
+ * error of the last attempt if all of them failed.
+ *
+ * To create a `TCPConnector` use the `create` function.
+ */
+class TCPConnector final: public Emitter<TCPConnector>, public std::enable_shared_from_this<TCPConnector> {
+    struct ConstructorAccess { explicit ConstructorAccess(int) {} };
+
+    void order(const addrinfo *info);
+    void next();
+    void win(TCPHandle &handle);
+    void lose(const ErrorEvent &event, TCPHandle &handle);
+    void fail(int err);
+    void reset() noexcept;
+
+public:
+    using Time = Loop::Time;
+
+    /*! @brief Default attempt delay, as recommended by RFC 8305. */
+    static constexpr Time DEFAULT_DELAY = Time{250};
+
+    explicit TCPConnector(ConstructorAccess, std::shared_ptr<Loop> ref);
+
+    /**
+     * @brief Creates a new connector.
+     * @param loop A loop to which the connections belong.
+     * @return A pointer to the newly created connector.
+     */
+    static std::shared_ptr<TCPConnector> create(std::shared_ptr<Loop> loop);
+
+    /*! @brief Releases the timer of the connector. */
+    ~TCPConnector() noexcept;
+
+    TCPConnector(const TCPConnector &) = delete;
+    TCPConnector(TCPConnector &&) = delete;
+
+    TCPConnector & operator=(const TCPConnector &) = delete;
+    TCPConnector & operator=(TCPConnector &&) = delete;
+
+    /**
+     * @brief Connects to a host.
+     *
+     * The connector keeps itself alive until the connection succeeds or
+     * fails. A connection still in progress is canceled.
+     *
+     * @param host The name or the address of the host.
+     * @param port The port to which to connect.
+     */
+    void connect(const std::string &host, unsigned int port);
+
+    /**
+     * @brief Sets the delay between two consecutive attempts.
+     * @param value The attempt delay, in milliseconds.
+     */
+    void attemptDelay(Time value) noexcept;
+
+    /**
+     * @brief Cancels the connection in progress, if any.
+     *
+     * All the pending attempts are closed and no events are emitted.
+     */
+    void cancel() noexcept;
+
+    /**
+     * @brief Checks if a connection is in progress.
+     * @return True if a connection is in progress, false otherwise.
+     */
+    bool pending() const noexcept;
+
+    /**
+     * @brief Gets the loop from which the connector was originated.
+     * @return A reference to a loop instance.
+     */
+    Loop & loop() const noexcept;
+
+private:
+    std::shared_ptr<Loop> pLoop;
+    std::shared_ptr<TCPConnector> self;
+    std::shared_ptr<GetAddrInfoReq> req;
+    std::shared_ptr<TimerHandle> timer;
+    std::vector<sockaddr_storage> candidates;
+    std::vector<std::shared_ptr<TCPHandle>> attempts;
+    std::size_t cursor;
+    Time delay;
+    int last;
+    bool starting;
+};
+
+
+}
+
+
+#ifndef UVW_AS_LIB
+#include "connector.cpp"
+#endif
+
+#endif // UVW_CONNECTOR_INCLUDE_H
@@ -3,14 +3,16 @@
 
 
 #include <type_traits>
-#include <functional>
 #include <algorithm>
 #include <utility>
 #include <cstddef>
-#include <unordered_map>
+#include <cstdint>
 #include <memory>
-#include <list>
+#include <iterator>
+#include <vector>
 #include <uv.h>
+#include "allocator.h"
+#include "function.hpp"
 #include "type_info.hpp"
 
 
@@ -86,6 +88,14 @@ private:
 template<typename T>
 class Emitter {
     struct BaseHandler {
+        static void * operator new(std::size_t size) {
+            return details::allocate(size);
+        }
+
+        static void operator delete(void *ptr) noexcept {
+            details::deallocate(ptr);
+        }
+
         virtual ~BaseHandler() noexcept = default;
         virtual bool empty() const noexcept = 0;
         virtual void clear() noexcept = 0;
@@ -93,86 +103,169 @@ class Emitter {
 
     template<typename E>
     struct Handler final: BaseHandler {
-        using Listener = std::function<void(E &, T &)>;
-        using Element = std::pair<bool, Listener>;
-        using ListenerList = std::list<Element>;
-        using Connection = typename ListenerList::iterator;
+        using Listener = Function<void(E &, T &)>;
+
+        struct Connection {
+            std::size_t stamp{};
+        };
+
+        struct Element {
+            Listener listener;
+            std::size_t stamp;
+            std::size_t claim;
+            bool once;
+            bool erased;
+        };
+
+        using ListenerList = std::vector<Element, details::AllocatorAdapter<Element>>;
 
         bool empty() const noexcept override {
-            auto pred = [](auto &&element){ return element.first; };
+            // once listeners claimed by an ongoing publish are already gone
+            auto pred = [](auto &&element){ return element.erased || element.claim; };
 
-            return std::all_of(onceL.cbegin(), onceL.cend(), pred) &&
-                    std::all_of(onL.cbegin(), onL.cend(), pred);
+            return std::all_of(listeners.cbegin(), listeners.cend(), pred) &&
+                    std::all_of(pending.cbegin(), pending.cend(), pred);
         }
 
         void clear() noexcept override {
             if(publishing) {
-                auto func = [](auto &&element){ element.first = true; };
-                std::for_each(onceL.begin(), onceL.end(), func);
-                std::for_each(onL.begin(), onL.end(), func);
+                auto func = [](auto &&element){ element.erased = true; };
+                std::for_each(listeners.begin(), listeners.end(), func);
+                std::for_each(pending.begin(), pending.end(), func);
+                dirty = true;
             } else {
-                onceL.clear();
-                onL.clear();
+                listeners.clear();
+                unclaimed = 0u;
             }
         }
 
         Connection once(Listener f) {
-            return onceL.emplace(onceL.cend(), false, std::move(f));
+            return push(std::move(f), true);
         }
 
         Connection on(Listener f) {
-            return onL.emplace(onL.cend(), false, std::move(f));
+            return push(std::move(f), false);
         }
 
         void erase(Connection conn) noexcept {
-            conn->first = true;
-
-            if(!publishing) {
-                auto pred = [](auto &&element){ return element.first; };
-                onceL.remove_if(pred);
-                onL.remove_if(pred);
+            // stamps are increasing, both lists are sorted by construction
+            auto pred = [](auto &&element, auto stamp){ return element.stamp < stamp; };
+
+            if(auto it = std::lower_bound(listeners.begin(), listeners.end(), conn.stamp, pred); it != listeners.end() && it->stamp == conn.stamp) {
+                if(publishing) {
+                    it->erased = true;
+                    dirty = true;
+                } else {
+                    unclaimed -= (it->once && !it->claim);
+                    listeners.erase(it);
+                }
+            } else if(auto it = std::lower_bound(pending.begin(), pending.end(), conn.stamp, pred); it != pending.end() && it->stamp == conn.stamp) {
+                it->erased = true;
             }
         }
 
-        void publish(E event, T &ref) {
-            ListenerList currentL;
-            onceL.swap(currentL);
+        void publish(E &event, T &ref) {
+            // listeners registered in the meantime go to the pending list, this one doesn't grow
+            const auto depth = ++publishing;
+            const bool claimed = unclaimed;
+            dirty = dirty || claimed;
+
+            for(auto pos = listeners.size(); unclaimed && pos; --pos) {
+                if(auto &element = listeners[pos - 1u]; element.once && !element.claim) {
+                    element.claim = depth;
+                    --unclaimed;
+                }
+            }
 
-            auto func = [&event, &ref](auto &&element) {
-                return element.first ? void() : element.second(event, ref);
-            };
+            for(auto pos = listeners.size(); pos; --pos) {
+                if(auto &element = listeners[pos - 1u]; !element.once && !element.erased) {
+                    element.listener(event, ref);
+                }
+            }
 
-            publishing = true;
+            for(auto pos = listeners.size(); claimed && pos; --pos) {
+                if(auto &element = listeners[pos - 1u]; element.claim == depth && !element.erased) {
+                    element.erased = true;
+                    element.listener(event, ref);
+                }
+            }
 
-            std::for_each(onL.rbegin(), onL.rend(), func);
-            std::for_each(currentL.rbegin(), currentL.rend(), func);
+            if(!--publishing) {
+                if(dirty) {
+                    listeners.erase(std::remove_if(listeners.begin(), listeners.end(), [](auto &&element){ return element.erased; }), listeners.end());
+                    dirty = false;
+                }
 
-            publishing = false;
+                for(auto &&element: pending) {
+                    if(!element.erased) {
+                        unclaimed += element.once;
+                        listeners.push_back(std::move(element));
+                    }
+                }
 
-            onL.remove_if([](auto &&element){ return element.first; });
+                pending.clear();
+            }
         }
 
     private:
-        bool publishing{false};
-        ListenerList onceL{};
-        ListenerList onL{};
+        Connection push(Listener f, bool once) {
+            auto &list = publishing ? pending : listeners;
+            list.push_back(Element{std::move(f), ++generation, {}, once, false});
+            unclaimed += (once && !publishing);
+            return Connection{list.back().stamp};
+        }
+
+        std::size_t generation{};
+        std::size_t unclaimed{};
+        std::size_t publishing{};
+        bool dirty{};
+        ListenerList listeners{};
+        ListenerList pending{};
     };
 
     template<typename E>
-    Handler<E> & handler() noexcept {
-        auto id = type<E>();
+    Handler<E> * lookup() const noexcept {
+        // emitters deal with a handful of event types, a linear scan is enough
+        const auto id = type<E>();
+        auto it = std::find_if(handlers.cbegin(), handlers.cend(), [id](auto &&hdlr){ return hdlr.first == id; });
+        return it == handlers.cend() ? nullptr : static_cast<Handler<E> *>(it->second.get());
+    }
 
-        if(!handlers.count(id)) {
-           handlers[id] = std::make_unique<Handler<E>>();
+    template<typename E>
+    Handler<E> & handler() noexcept {
+        if(auto *hdlr = lookup<E>(); hdlr) {
+            return *hdlr;
         }
 
-        return static_cast<Handler<E>&>(*handlers.at(id));
+        return static_cast<Handler<E>&>(*handlers.emplace_back(type<E>(), std::make_unique<Handler<E>>()).second);
     }
 
 protected:
+    /**
+     * @brief Publishes an event to the listeners registered for its type.
+     *
+     * Events are never copied nor moved while they are dispatched. A temporary
+     * is constructed once by the caller and handed over to all the listeners
+     * by reference.<br/>
+     * Non-const lvalues are _borrowed_ instead: the caller keeps the ownership
+     * of the event and listeners work directly on it, with no copies
+     * involved. Const lvalues are copied once, since listeners are allowed to
+     * modify the events they receive.
+     *
+     * @param event The event to publish.
+     */
     template<typename E>
-    void publish(E event) {
-        handler<E>().publish(std::move(event), *static_cast<T*>(this));
+    void publish(E &&event) {
+        using Type = std::remove_cv_t<std::remove_reference_t<E>>;
+
+        if(auto *hdlr = lookup<Type>(); hdlr) {
+            if constexpr(std::is_const_v<std::remove_reference_t<E>>) {
+                Type copy{event};
+                hdlr->publish(copy, *static_cast<T*>(this));
+            } else {
+                hdlr->publish(event, *static_cast<T*>(this));
+            }
+        }
     }
 
 public:
@@ -195,7 +288,7 @@ public:
         Connection(Connection &&) = default;
 
         Connection(typename Handler<E>::Connection conn)
-            : Handler<E>::Connection{std::move(conn)}
+            : Handler<E>::Connection{conn}
         {}
 
         Connection & operator=(const Connection &) = default;
@@ -215,8 +308,9 @@ public:
      * can be used later to disconnect the listener, if needed.
      *
      * Listener is usually defined as a callable object assignable to a
-     * `std::function<void(const E &, T &)`, where `E` is the type of the event
-     * and `T` is the type of the resource.
+     * `Function<void(E &, T &)>`, where `E` is the type of the event and `T`
+     * is the type of the resource. Listeners are move-only and they don't
+     * allocate as long as their captures fit the inline storage.
      *
      * @param f A valid listener to be registered.
      * @return Connection object to be used later to disconnect the listener.
@@ -235,8 +329,9 @@ public:
      * can be used later to disconnect the listener, if needed.
      *
      * Listener is usually defined as a callable object assignable to a
-     * `std::function<void(const E &, T &)`, where `E` is the type of the event
-     * and `T` is the type of the resource.
+     * `Function<void(E &, T &)>`, where `E` is the type of the event and `T`
+     * is the type of the resource. Listeners are move-only and they don't
+     * allocate as long as their captures fit the inline storage.
      *
      * @param f A valid listener to be registered.
      * @return Connection object to be used later to disconnect the listener.
@@ -268,7 +363,7 @@ public:
      */
     void clear() noexcept {
         std::for_each(handlers.begin(), handlers.end(),
-                      [](auto &&hdlr){ if(hdlr.second) { hdlr.second->clear(); } });
+                      [](auto &&hdlr){ hdlr.second->clear(); });
     }
 
     /**
@@ -278,10 +373,8 @@ public:
      */
     template<typename E>
     bool empty() const noexcept {
-        auto id = type<E>();
-
-        return (!handlers.count(id) ||
-            static_cast<Handler<E>&>(*handlers.at(id)).empty());
+        auto *hdlr = lookup<E>();
+        return (!hdlr || hdlr->empty());
     }
 
     /**
@@ -291,11 +384,12 @@ public:
      */
     bool empty() const noexcept {
         return std::all_of(handlers.cbegin(), handlers.cend(),
-                           [](auto &&hdlr){ return !hdlr.second || hdlr.second->empty(); });
+                           [](auto &&hdlr){ return hdlr.second->empty(); });
     }
 
 private:
-    std::unordered_map<std::uint32_t, std::unique_ptr<BaseHandler>> handlers{};
+    using HandlerSlot = std::pair<std::uint32_t, std::unique_ptr<BaseHandler>>;
+    std::vector<HandlerSlot, details::AllocatorAdapter<HandlerSlot>> handlers{};
 };
 
 
@@ -85,15 +85,15 @@ UVW_INLINE bool FileReq::openSync(const std::string &path, Flags<FileOpen> flags
 
 
 UVW_INLINE void FileReq::read(int64_t offset, unsigned int len) {
-    current = std::unique_ptr<char[]>{new char[len]};
+    current = std::unique_ptr<char[], BufferDeleter>{static_cast<char *>(details::allocate(len)), BufferDeleter::heap()};
     buffer = uv_buf_init(current.get(), len);
     uv_buf_t bufs[] = {buffer};
     cleanupAndInvoke(&uv_fs_read, parent(), get(), file, bufs, 1, offset, &fsReadCallback);
 }
 
 
-UVW_INLINE std::pair<bool, std::pair<std::unique_ptr<const char[]>, std::size_t>> FileReq::readSync(int64_t offset, unsigned int len) {
-    current = std::unique_ptr<char[]>{new char[len]};
+UVW_INLINE std::pair<bool, std::pair<std::unique_ptr<const char[], BufferDeleter>, std::size_t>> FileReq::readSync(int64_t offset, unsigned int len) {
+    current = std::unique_ptr<char[], BufferDeleter>{static_cast<char *>(details::allocate(len)), BufferDeleter::heap()};
     buffer = uv_buf_init(current.get(), len);
     uv_buf_t bufs[] = {buffer};
     auto req = get();
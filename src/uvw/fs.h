@@ -181,12 +181,19 @@ struct FsEvent {
  */
 template<>
 struct FsEvent<details::UVFsType::READ> {
-    FsEvent(const char *pathname, std::unique_ptr<const char[]> buf, std::size_t sz) noexcept
+    FsEvent(const char *pathname, std::unique_ptr<const char[], BufferDeleter> buf, std::size_t sz) noexcept
         : path{pathname}, data{std::move(buf)}, size{sz}
     {}
 
     const char * path; /*!< The path affecting the request. */
-    std::unique_ptr<const char[]> data; /*!< A bunch of data read from the given path. */
+    /**
+     * @brief A bunch of data read from the given path.
+     *
+     * The buffer comes from the allocation functions in use. This is a
+     * breaking change: it used to be an `std::unique_ptr<const char[]>`, use
+     * `std::unique_ptr<const char[], BufferDeleter>` (or `auto`) to store it.
+     */
+    std::unique_ptr<const char[], BufferDeleter> data;
     std::size_t size; /*!< The amount of data read from the given path. */
 };
 
@@ -555,6 +562,10 @@ public:
     /**
      * @brief Sync [read](http://linux.die.net/man/2/preadv).
      *
+     * The buffer comes from the allocation functions in use. This is a
+     * breaking change: it used to be an `std::unique_ptr<const char[]>`, use
+     * `std::unique_ptr<const char[], BufferDeleter>` (or `auto`) to store it.
+     *
      * @param offset Offset, as described in the official documentation.
      * @param len Length, as described in the official documentation.
      *
@@ -564,7 +575,7 @@ public:
      *   * A bunch of data read from the given path.
      *   * The amount of data read from the given path.
      */
-    std::pair<bool, std::pair<std::unique_ptr<const char[]>, std::size_t>> readSync(int64_t offset, unsigned int len);
+    std::pair<bool, std::pair<std::unique_ptr<const char[], BufferDeleter>, std::size_t>> readSync(int64_t offset, unsigned int len);
 
     /**
      * @brief Async [write](http://linux.die.net/man/2/pwritev).
@@ -766,7 +777,7 @@ public:
     operator FileHandle() const noexcept;
 
 private:
-    std::unique_ptr<char[]> current{nullptr};
+    std::unique_ptr<char[], BufferDeleter> current{nullptr};
     uv_buf_t buffer{};
     uv_file file{BAD_FD};
 };
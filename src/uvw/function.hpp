@@ -0,0 +1,241 @@
+#ifndef UVW_FUNCTION_INCLUDE_HPP
+#define UVW_FUNCTION_INCLUDE_HPP
+
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "allocator.h"
+
+
+namespace uvw {
+
+
+/**
+ * @brief Move-only function wrapper with a configurable inline storage.
+ *
+ * Primary template isn't defined on purpose. All the specializations give a
+ * compile-time error unless the template parameter is a function type.
+ */
+template<typename, std::size_t = 4u * sizeof(void *)>
+class Function;
+
+
+/**
+ * @brief Move-only function wrapper with a configurable inline storage.
+ *
+ * It's a lightweight replacement for `std::function` that never copies the
+ * target and never allocates as long as it fits the inline storage, that is
+ * when its size doesn't exceed `Len` bytes and it's nothrow move
+ * constructible.<br/>
+ * Larger targets spill to the heap, the same as with `std::function`, and
+ * draw from the allocation functions in use unless they are over-aligned.
+ *
+ * @tparam Ret Return type of the function type.
+ * @tparam Args Types of arguments of the function type.
+ * @tparam Len Size of the inline storage, in bytes.
+ */
+template<typename Ret, typename... Args, std::size_t Len>
+class Function<Ret(Args...), Len> {
+    static_assert(Len >= sizeof(void *), "Inline storage must fit at least a pointer");
+
+    enum class Operation { MOVE, DESTROY };
+
+    using InvokeFn = Ret(void *, Args&&...);
+    using ManageFn = void(Operation, Function &, Function *) noexcept;
+
+    template<typename Type>
+    static constexpr bool inlined = sizeof(Type) <= Len
+        && alignof(Type) <= alignof(std::max_align_t)
+        && std::is_nothrow_move_constructible_v<Type>;
+
+    // over-aligned targets can't come from the allocation functions in use
+    template<typename Type>
+    static constexpr bool allocated = alignof(Type) <= alignof(std::max_align_t);
+
+    // empty functions behave like an empty std::function, with no checks on the hot path
+    [[noreturn]] static Ret fail(void *, Args&&...) {
+        throw std::bad_function_call{};
+    }
+
+    template<typename Type>
+    static Ret invoke(void *instance, Args&&... args) {
+        if constexpr(std::is_void_v<Ret>) {
+            // the value returned by the target, if any, is discarded
+            std::invoke(*static_cast<Type *>(instance), std::forward<Args>(args)...);
+        } else {
+            return std::invoke(*static_cast<Type *>(instance), std::forward<Args>(args)...);
+        }
+    }
+
+    template<typename Type>
+    static void manage(Operation op, Function &self, Function *other) noexcept {
+        if constexpr(inlined<Type>) {
+            auto *instance = static_cast<Type *>(self.instance);
+
+            if(op == Operation::MOVE) {
+                other->instance = ::new (&other->storage) Type{std::move(*instance)};
+            }
+
+            instance->~Type();
+        } else {
+            if(op == Operation::MOVE) {
+                other->instance = self.instance;
+            } else if constexpr(allocated<Type>) {
+                details::AllocatorDeleter<Type>{}(static_cast<Type *>(self.instance));
+            } else {
+                delete static_cast<Type *>(self.instance);
+            }
+        }
+    }
+
+    template<typename Type>
+    static bool null(const Type &func) noexcept {
+        if constexpr(std::is_pointer_v<Type> || std::is_member_pointer_v<Type>) {
+            return func == nullptr;
+        } else {
+            return false;
+        }
+    }
+
+    void steal(Function &other) noexcept {
+        if(other.manager) {
+            other.manager(Operation::MOVE, other, this);
+            invoker = std::exchange(other.invoker, &fail);
+            manager = std::exchange(other.manager, nullptr);
+            other.instance = nullptr;
+        }
+    }
+
+    void reset() noexcept {
+        if(manager) {
+            manager(Operation::DESTROY, *this, nullptr);
+            invoker = &fail;
+            manager = nullptr;
+            instance = nullptr;
+        }
+    }
+
+public:
+    /*! @brief Default constructor, the function is empty. */
+    Function() noexcept = default;
+
+    /*! @brief Constructs an empty function. */
+    Function(std::nullptr_t) noexcept
+        : Function{}
+    {}
+
+    /**
+     * @brief Constructs a function from a callable object.
+     *
+     * The callable object is stored inline if possible, otherwise it's moved
+     * to the heap. Null function pointers result in empty functions.
+     *
+     * @tparam Func Type of the callable object.
+     * @param func A valid callable object.
+     */
+    template<typename Func, typename Type = std::decay_t<Func>, typename = std::enable_if_t<!std::is_same_v<Type, Function> && std::is_invocable_r_v<Ret, Type &, Args...>>>
+    Function(Func &&func)
+        : Function{}
+    {
+        if(!null<Type>(func)) {
+            if constexpr(inlined<Type>) {
+                instance = ::new (&storage) Type{std::forward<Func>(func)};
+            } else if constexpr(allocated<Type>) {
+                instance = details::allocateUnique<Type>(std::forward<Func>(func)).release();
+            } else {
+                instance = new Type{std::forward<Func>(func)};
+            }
+
+            invoker = &invoke<Type>;
+            manager = &manage<Type>;
+        }
+    }
+
+    /**
+     * @brief Move constructor.
+     * @param other The instance to move from.
+     */
+    Function(Function &&other) noexcept
+        : Function{}
+    {
+        steal(other);
+    }
+
+    Function(const Function &) = delete;
+
+    /*! @brief Destroys the target, if any. */
+    ~Function() noexcept {
+        reset();
+    }
+
+    /**
+     * @brief Move assignment operator.
+     * @param other The instance to move from.
+     * @return This function.
+     */
+    Function & operator=(Function &&other) noexcept {
+        if(this != &other) {
+            reset();
+            steal(other);
+        }
+
+        return *this;
+    }
+
+    Function & operator=(const Function &) = delete;
+
+    /**
+     * @brief Destroys the target, if any.
+     * @return This function.
+     */
+    Function & operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    /**
+     * @brief Invokes the target.
+     *
+     * Invoking an empty function throws `std::bad_function_call`, the same as
+     * with `std::function`.
+     *
+     * @param args Parameters to pass to the target.
+     * @return The value returned by the target, if any.
+     */
+    Ret operator()(Args... args) const {
+        return invoker(instance, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Checks if the function has a target.
+     * @return True if the function has a target, false otherwise.
+     */
+    explicit operator bool() const noexcept {
+        return (manager != nullptr);
+    }
+
+    /**
+     * @brief Checks if a callable object would be stored inline.
+     * @tparam Func Type of the callable object.
+     * @return True if the callable object doesn't require allocations, false
+     * otherwise.
+     */
+    template<typename Func>
+    static constexpr bool fits() noexcept {
+        return inlined<std::decay_t<Func>>;
+    }
+
+private:
+    InvokeFn *invoker{&fail};
+    ManageFn *manager{nullptr};
+    void *instance{nullptr};
+    alignas(std::max_align_t) unsigned char storage[Len];
+};
+
+
+}
+
+#endif // UVW_FUNCTION_INCLUDE_HPP
@@ -37,9 +37,36 @@ protected:
 		ref.publish(CloseEvent{});
 	}
 
-	static void allocCallback(uv_handle_t *, std::size_t suggested, uv_buf_t *buf) {
-		auto size = static_cast<unsigned int>(suggested);
-		*buf = uv_buf_init(new char[size], size);
+	static void allocCallback(uv_handle_t *handle, std::size_t suggested, uv_buf_t *buf) {
+		Handle<T, U> &ref = *(static_cast<T*>(handle->data));
+		ref.lend(suggested, buf, [&ref](std::size_t size) { return ref.loop().bufferPool().allocate(size); });
+	}
+
+	template<typename F>
+	void lend(std::size_t size, uv_buf_t *buf, F fallback) {
+		// user defined allocators take precedence over the default source
+		auto data = alloc ? alloc(size) : fallback(size);
+		auto len = data ? static_cast<unsigned int>(size) : 0u;
+		// the deleter is kept aside until the read callback takes the buffer back
+		deleter = data.get_deleter();
+		*buf = uv_buf_init(data.release(), len);
+	}
+
+	template<typename E>
+	auto relay() {
+		// completion of internal requests, the outcome is published on the handle
+		return [ptr = this->shared_from_this()](int status) {
+			if(status) { ptr->publish(ErrorEvent{status}); }
+			else { ptr->publish(E{}); }
+		};
+	}
+
+	std::unique_ptr<char[], BufferDeleter> acquire(char *base) noexcept {
+		return std::unique_ptr<char[], BufferDeleter>{base, std::exchange(deleter, BufferDeleter{})};
+	}
+
+	void allocator(BufferAllocator allocator) noexcept {
+		alloc = std::move(allocator);
 	}
 
 	template<typename F, typename... Args>
@@ -269,6 +296,10 @@ public:
 		uv_fileno(this->template get<uv_handle_t>(), &fd);
 		return fd;
 	}
+
+private:
+	BufferAllocator alloc{};
+	BufferDeleter deleter{};
 };
 
 
@@ -9,7 +9,8 @@ namespace uvw {
 
 
 UVW_INLINE Loop::Loop(std::unique_ptr<uv_loop_t, Deleter> ptr) noexcept
-    : loop{std::move(ptr)}
+    : loop{std::move(ptr)},
+      pool{new BufferPool{BufferPool::DEFAULT_LIMIT}, [](BufferPool *buffers) { buffers->detach(); }}
 {}
 
 
@@ -63,8 +64,14 @@ UVW_INLINE Loop::~Loop() noexcept {
 
 
 UVW_INLINE void Loop::close() {
-    auto err = uv_loop_close(loop.get());
-    return err ? publish(ErrorEvent{err}) : loop.reset();
+    if(auto err = uv_loop_close(loop.get()); err) {
+        publish(ErrorEvent{err});
+    } else {
+        // parked requests give their blocks back before the slabs are released
+        recyclers.clear();
+        slabPools.clear();
+        loop.reset();
+    }
 }
 
 
@@ -126,6 +133,21 @@ UVW_INLINE void Loop::data(std::shared_ptr<void> uData) {
 }
 
 
+UVW_INLINE BufferPool & Loop::bufferPool() const noexcept {
+    return *pool;
+}
+
+
+UVW_INLINE void Loop::slabs(bool enable) noexcept {
+    slabbed = enable;
+}
+
+
+UVW_INLINE bool Loop::slabs() const noexcept {
+    return slabbed;
+}
+
+
 UVW_INLINE const uv_loop_t *Loop::raw() const noexcept {
     return loop.get();
 }
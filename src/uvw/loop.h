@@ -6,13 +6,19 @@
 #include <ciso646>
 #endif
 
+#include <algorithm>
 #include <functional>
 #include <memory>
+#include <cstdint>
 #include <utility>
 #include <type_traits>
+#include <vector>
 #include <chrono>
 #include <uv.h>
+#include "buffer.h"
 #include "emitter.h"
+#include "slab.h"
+#include "type_info.hpp"
 #include "util.h"
 
 
@@ -68,16 +74,96 @@ class Loop final: public Emitter<Loop>, public std::enable_shared_from_this<Loop
     template<typename, typename>
     friend class Resource;
 
+    template<typename, typename>
+    friend class Request;
+
+    static constexpr std::size_t RECYCLE_LIMIT = 64u;
+
+    struct BaseRecycler {
+        virtual ~BaseRecycler() noexcept = default;
+    };
+
+    template<typename R>
+    struct Recycler final: BaseRecycler {
+        std::vector<std::shared_ptr<R>> free;
+    };
+
+    template<typename R>
+    Recycler<R> * lookupRecycler() const noexcept {
+        const auto id = type<R>();
+        auto it = std::find_if(recyclers.cbegin(), recyclers.cend(), [id](auto &&elem){ return elem.first == id; });
+        return it == recyclers.cend() ? nullptr : static_cast<Recycler<R> *>(it->second.get());
+    }
+
+    template<typename R>
+    Recycler<R> & recycler() {
+        if(auto *curr = lookupRecycler<R>(); curr) {
+            return *curr;
+        }
+
+        return static_cast<Recycler<R> &>(*recyclers.emplace_back(type<R>(), std::make_unique<Recycler<R>>()).second);
+    }
+
+    template<typename R>
+    std::shared_ptr<R> reuse() noexcept {
+        std::shared_ptr<R> ptr{};
+
+        if(auto *curr = lookupRecycler<R>(); curr && !curr->free.empty()) {
+            ptr = std::move(curr->free.back());
+            curr->free.pop_back();
+        }
+
+        return ptr;
+    }
+
+    template<typename R>
+    void park(std::shared_ptr<R> ptr) {
+        if(auto &free = recycler<R>().free; free.size() < RECYCLE_LIMIT) {
+            free.push_back(std::move(ptr));
+        }
+    }
+
+    struct SlabDeleter {
+        void operator()(SlabPool *slabs) const noexcept {
+            slabs->detach();
+        }
+    };
+
+    template<typename R>
+    SlabPool * lookupSlab() const noexcept {
+        const auto id = type<R>();
+        auto it = std::find_if(slabPools.cbegin(), slabPools.cend(), [id](auto &&elem){ return elem.first == id; });
+        return it == slabPools.cend() ? nullptr : it->second.get();
+    }
+
+    template<typename R>
+    SlabPool & slab() {
+        if(auto *curr = lookupSlab<R>(); curr) {
+            return *curr;
+        }
+
+        return *slabPools.emplace_back(type<R>(), std::unique_ptr<SlabPool, SlabDeleter>{new SlabPool{}}).second;
+    }
+
+    template<typename R, typename... Args>
+    std::shared_ptr<R> make(Args&&... args) {
+        if(slabbed) {
+            return R::allocate(SlabAllocator<R>{slab<R>()}, shared_from_this(), std::forward<Args>(args)...);
+        }
+
+        return R::create(shared_from_this(), std::forward<Args>(args)...);
+    }
+
     template<typename R, typename... Args>
     auto create_resource(int, Args&&... args) -> decltype(std::declval<R>().init(), std::shared_ptr<R>{}) {
-        auto ptr = R::create(shared_from_this(), std::forward<Args>(args)...);
+        auto ptr = make<R>(std::forward<Args>(args)...);
         ptr = ptr->init() ? ptr : nullptr;
         return ptr;
     }
 
     template<typename R, typename... Args>
     std::shared_ptr<R> create_resource(char, Args&&... args) {
-        return R::create(shared_from_this(), std::forward<Args>(args)...);
+        return make<R>(std::forward<Args>(args)...);
     }
 
     Loop(std::unique_ptr<uv_loop_t, Deleter> ptr) noexcept;
@@ -377,6 +463,46 @@ public:
      */
     void data(std::shared_ptr<void> uData);
 
+    /**
+     * @brief Gets the pool of buffers of the loop.
+     *
+     * Handles draw from this pool the buffers used to read data. Buffers go
+     * back to the pool when the events that carry them are destroyed.
+     *
+     * @return The pool of buffers of the loop.
+     */
+    BufferPool & bufferPool() const noexcept;
+
+    /**
+     * @brief Enables or disables slabs for the resources of the loop.
+     *
+     * When enabled, resources created with `resource()` are packed in per-type
+     * slabs owned by the loop rather than allocated one by one. Resources
+     * created in the meantime are left untouched when slabs are disabled.<br/>
+     * Slabs are freed when the loop is closed or destroyed, as soon as the
+     * resources allocated from them go away.
+     *
+     * @param enable True to enable slabs, false otherwise.
+     */
+    void slabs(bool enable) noexcept;
+
+    /**
+     * @brief Checks if slabs are enabled for the resources of the loop.
+     * @return True if slabs are enabled, false otherwise.
+     */
+    bool slabs() const noexcept;
+
+    /**
+     * @brief Gets the statistics of the slabs of a type of resource.
+     * @return A snapshot of the statistics, empty if there are no slabs for
+     * the given type.
+     */
+    template<typename R>
+    SlabPool::Stats slabStats() const noexcept {
+        auto *curr = lookupSlab<R>();
+        return curr ? curr->stats() : SlabPool::Stats{};
+    }
+
     /**
      * @brief Gets the underlying raw data structure.
      *
@@ -413,7 +539,11 @@ public:
 
 private:
     std::unique_ptr<uv_loop_t, Deleter> loop;
+    std::unique_ptr<BufferPool, void(*)(BufferPool *)> pool;
     std::shared_ptr<void> userData{nullptr};
+    std::vector<std::pair<std::uint32_t, std::unique_ptr<SlabPool, SlabDeleter>>> slabPools{};
+    std::vector<std::pair<std::uint32_t, std::unique_ptr<BaseRecycler>>> recyclers{};
+    bool slabbed{false};
 };
 
 
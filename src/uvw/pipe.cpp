@@ -30,13 +30,8 @@ UVW_INLINE void PipeHandle::bind(const std::string &name) {
 
 
 UVW_INLINE void PipeHandle::connect(const std::string &name) {
-    auto listener = [ptr = shared_from_this()](const auto &event, const auto &) {
-        ptr->publish(event);
-    };
-
-    auto connect = loop().resource<details::ConnectReq>();
-    connect->once<ErrorEvent>(listener);
-    connect->once<ConnectEvent>(listener);
+    auto connect = details::ConnectReq::acquire(loop());
+    connect->completion(relay<ConnectEvent>());
     connect->connect(&uv_pipe_connect, get(), name.data());
 }
 
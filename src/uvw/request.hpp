@@ -6,12 +6,27 @@
 #include <utility>
 #include <memory>
 #include <uv.h>
+#include "function.hpp"
 #include "resource.hpp"
 
 
 namespace uvw {
 
 
+namespace details {
+
+
+template<typename R, typename = void>
+struct Recyclable: std::false_type {};
+
+
+template<typename R>
+struct Recyclable<R, std::enable_if_t<R::RECYCLABLE>>: std::true_type {};
+
+
+}
+
+
 /**
  * @brief Request base class.
  *
@@ -26,11 +41,51 @@ protected:
         return ptr;
     }
 
+    using Completion = Function<void(int)>;
+
     template<typename E>
     static void defaultCallback(U *req, int status) {
         auto ptr = reserve(req);
-        if(status) { ptr->publish(ErrorEvent{status}); }
+        if(ptr->done) { std::exchange(ptr->done, nullptr)(status); }
+        else if(status) { ptr->publish(ErrorEvent{status}); }
         else { ptr->publish(E{}); }
+        if constexpr(details::Recyclable<T>::value) { recycle(std::move(ptr)); }
+    }
+
+    void completion(Completion func) noexcept {
+        // internal requests report to their owners directly, they don't emit events
+        done = std::move(func);
+    }
+
+    template<typename... Args>
+    static std::shared_ptr<T> acquire(Loop &loop, Args&&... args) {
+        std::shared_ptr<T> ptr{};
+
+        if constexpr(details::Recyclable<T>::value) {
+            if(ptr = loop.template reuse<T>(); ptr) {
+                ptr->rebind(loop.shared_from_this());
+                ptr->assign(std::forward<Args>(args)...);
+            }
+        }
+
+        return ptr ? ptr : loop.template resource<T>(std::forward<Args>(args)...);
+    }
+
+    static void recycle(std::shared_ptr<T> ptr) {
+        // requests still referenced elsewhere can't be reused
+        if(ptr.use_count() == 1) {
+            // the loop could go away along with the last reference to it
+            auto loop = ptr->loop().shared_from_this();
+
+            ptr->discard();
+            ptr->done = nullptr;
+            ptr->clear();
+            *ptr->get() = U{};
+            ptr->get()->data = ptr.get();
+            // parked requests don't keep the loop alive, it owns them
+            ptr->rebind(nullptr);
+            loop->template park<T>(std::move(ptr));
+        }
     }
 
     template<typename F, typename... Args>
@@ -40,7 +95,8 @@ protected:
             this->leak();
         } else {
             auto err = std::forward<F>(f)(std::forward<Args>(args)...);
-            if(err) { Emitter<T>::publish(ErrorEvent{err}); }
+            if(err && done) { std::exchange(done, nullptr)(err); }
+            else if(err) { Emitter<T>::publish(ErrorEvent{err}); }
             else { this->leak(); }
         }
     }
@@ -72,6 +128,9 @@ public:
     std::size_t size() const noexcept {
         return uv_req_size(this->template get<uv_req_t>()->type);
     }
+
+private:
+    Completion done{};
 };
 
 
@@ -63,7 +63,7 @@ public:
 
 private:
     std::shared_ptr<void> userData{nullptr};
-    std::shared_ptr<void> sPtr{nullptr};
+    std::shared_ptr<T> sPtr{nullptr};
 };
 
 }
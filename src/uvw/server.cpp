@@ -0,0 +1,446 @@
+#ifdef UVW_AS_LIB
+#include "server.h"
+#endif
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "check.h"
+#include "config.h"
+#include "fs_event.h"
+#include "fs_poll.h"
+#include "idle.h"
+#include "pipe.h"
+#include "poll.h"
+#include "prepare.h"
+#include "process.h"
+#include "signal.h"
+#include "timer.h"
+#include "tty.h"
+#include "udp.h"
+
+
+namespace uvw {
+
+
+UVW_INLINE void details::LoopGroup::pin([[maybe_unused]] std::size_t cpu) noexcept {
+#ifdef __linux__
+    const std::size_t cores = std::thread::hardware_concurrency();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((cores ? cpu % cores : 0u) % CPU_SETSIZE, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+
+UVW_INLINE bool details::LoopGroup::prepare(Worker &worker) {
+    worker.loop = Loop::create();
+    worker.async = worker.loop ? worker.loop->resource<AsyncHandle>() : nullptr;
+
+    if(worker.async) {
+        // user code can create any type of handle, all of them are closed on stop
+        worker.async->on<AsyncEvent>([](const AsyncEvent &, AsyncHandle &handle) {
+            handle.loop().walk([](auto &&h) { h.close(); });
+        });
+    }
+
+    return (worker.async != nullptr);
+}
+
+
+UVW_INLINE bool details::LoopGroup::launch(Worker &worker, std::size_t cpu) {
+    worker.thread = worker.loop->resource<Thread>([&worker, cpu](std::shared_ptr<void>) {
+        pin(cpu);
+        worker.loop->run();
+    });
+
+    worker.running = worker.thread->run();
+    return worker.running;
+}
+
+
+UVW_INLINE void details::LoopGroup::signal(Worker &worker) noexcept {
+    if(worker.running) {
+        worker.async->send();
+    }
+}
+
+
+UVW_INLINE void details::LoopGroup::release(Worker &worker) noexcept {
+    if(worker.loop) {
+        if(!std::exchange(worker.running, false)) {
+            // never started, the loop is run in place to close the handles
+            worker.loop->walk([](auto &&h) { h.close(); });
+            worker.loop->run();
+        }
+
+        // threads are joined on destruction
+        worker.thread.reset();
+        worker.async.reset();
+        worker.loop->close();
+        worker.loop.reset();
+    }
+}
+
+
+UVW_INLINE details::LoopGroup::LoopGroup(std::size_t count)
+    : workers{}
+{
+    count = count ? count : std::thread::hardware_concurrency();
+    workers.resize(count ? count : 1u);
+}
+
+
+UVW_INLINE bool details::LoopGroup::busy() const noexcept {
+    return std::any_of(workers.cbegin(), workers.cend(), [](auto &&worker) { return worker && worker->loop; });
+}
+
+
+UVW_INLINE void details::LoopGroup::halt() noexcept {
+    for(auto &&worker: workers) {
+        if(worker) {
+            signal(*worker);
+        }
+    }
+
+    for(auto &&worker: workers) {
+        if(worker) {
+            release(*worker);
+        }
+    }
+}
+
+
+UVW_INLINE std::size_t details::LoopGroup::size() const noexcept {
+    return workers.size();
+}
+
+
+UVW_INLINE std::size_t details::LoopGroup::connections(std::size_t pos) const noexcept {
+    return workers[pos] ? workers[pos]->connections.load() : 0u;
+}
+
+
+UVW_INLINE std::size_t details::LoopGroup::accepted(std::size_t pos) const noexcept {
+    return workers[pos] ? workers[pos]->accepted.load() : 0u;
+}
+
+
+UVW_INLINE bool ReusePortServer::setup([[maybe_unused]] Worker &worker, [[maybe_unused]] const sockaddr &addr) {
+#ifdef SO_REUSEPORT
+    auto listener = worker.loop->resource<TCPHandle>(addr.sa_family);
+
+    if(!listener) {
+        return false;
+    }
+
+    int enable = 1;
+    // the option must be set before to bind the socket
+    bool ok = (0 == setsockopt(listener->fd(), SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)));
+    auto conn = listener->on<ErrorEvent>([&ok](const auto &, auto &) { ok = false; });
+
+    if(ok) {
+        listener->bind(addr);
+    }
+
+    if(ok) {
+        listener->listen();
+    }
+
+    listener->erase(conn);
+
+    listener->on<ListenEvent>([this, &worker](const ListenEvent &, TCPHandle &handle) {
+        auto client = handle.loop().resource<TCPHandle>();
+
+        if(client) {
+            handle.accept(*client);
+
+            if(client->readable()) {
+                ++worker.accepted;
+                ++worker.connections;
+                client->on<CloseEvent>([&worker](const CloseEvent &, TCPHandle &) { --worker.connections; });
+                callback(*client);
+            } else {
+                client->close();
+            }
+        }
+    });
+
+    return ok;
+#else
+    return false;
+#endif
+}
+
+
+UVW_INLINE ReusePortServer::ReusePortServer(Callback cb, std::size_t count)
+    : LoopGroup{count}, callback{std::move(cb)}
+{}
+
+
+UVW_INLINE ReusePortServer::~ReusePortServer() noexcept {
+    stop();
+}
+
+
+UVW_INLINE bool ReusePortServer::start(const sockaddr &addr) {
+    if(busy()) {
+        // already running
+        return false;
+    }
+
+    bool ok = true;
+
+    for(auto pos = 0u; pos < workers.size() && ok; ++pos) {
+        auto &worker = *(workers[pos] = std::make_unique<Worker>());
+        ok = prepare(worker) && setup(worker, addr);
+    }
+
+    for(auto pos = 0u; pos < workers.size() && ok; ++pos) {
+        ok = launch(*workers[pos], pos);
+    }
+
+    if(!ok) {
+        stop();
+    }
+
+    return ok;
+}
+
+
+template<typename I>
+UVW_INLINE bool ReusePortServer::start(const std::string &ip, unsigned int port) {
+    typename details::IpTraits<I>::Type addr;
+    details::IpTraits<I>::addrFunc(ip.data(), port, &addr);
+    return start(reinterpret_cast<const sockaddr &>(addr));
+}
+
+
+template<typename I>
+UVW_INLINE bool ReusePortServer::start(Addr addr) {
+    return start<I>(std::move(addr.ip), addr.port);
+}
+
+
+UVW_INLINE void ReusePortServer::stop() noexcept {
+    halt();
+}
+
+
+UVW_INLINE bool DispatchServer::setup([[maybe_unused]] Worker &worker, [[maybe_unused]] Channel &channel) {
+#ifdef _WIN32
+    return false;
+#else
+    uv_os_sock_t fds[2];
+
+    if(uv_socketpair(SOCK_STREAM, 0, fds, 0, 0)) {
+        return false;
+    }
+
+    auto pipe = worker.loop->resource<PipeHandle>(true);
+    channel.pipe = acceptor.loop->resource<PipeHandle>(true);
+
+    if(!pipe || !channel.pipe) {
+        ::close(fds[0]);
+        ::close(fds[1]);
+        return false;
+    }
+
+    pipe->open(FileHandle{fds[1]});
+    channel.pipe->open(FileHandle{fds[0]});
+
+    // handles are sent in order, the one in front of the queue is the one just sent
+    channel.pipe->on<WriteEvent>([&channel](const WriteEvent &, PipeHandle &) {
+        channel.queue.front()->close();
+        channel.queue.pop_front();
+    });
+
+    // writes that fail right away are the last ones queued, the others complete in order
+    channel.pipe->on<ErrorEvent>([&channel, &worker](const ErrorEvent &, PipeHandle &) {
+        if(!channel.queue.empty()) {
+            --worker.connections;
+
+            if(channel.sending) {
+                channel.queue.back()->close();
+                channel.queue.pop_back();
+            } else {
+                channel.queue.front()->close();
+                channel.queue.pop_front();
+            }
+        }
+    });
+
+    pipe->on<DataEvent>([this, &worker](const DataEvent &, PipeHandle &handle) {
+        while(handle.pending() > 0) {
+            auto client = handle.loop().resource<TCPHandle>();
+
+            if(client) {
+                handle.accept(*client);
+            }
+
+            if(client && client->readable()) {
+                ++worker.accepted;
+                client->on<CloseEvent>([&worker](const CloseEvent &, TCPHandle &) { --worker.connections; });
+                callback(*client);
+            } else {
+                --worker.connections;
+
+                if(client) {
+                    client->close();
+                }
+            }
+        }
+    });
+
+    pipe->read();
+
+    return true;
+#endif
+}
+
+
+UVW_INLINE std::size_t DispatchServer::pick() noexcept {
+    auto pos = next;
+    next = (next + 1u) % workers.size();
+
+    if(policy == Policy::LEAST_CONNECTIONS) {
+        // starting from a different worker each time spreads ties evenly
+        for(auto offset = 1u; offset < workers.size(); ++offset) {
+            auto curr = (next + offset - 1u) % workers.size();
+            pos = (workers[curr]->connections < workers[pos]->connections) ? curr : pos;
+        }
+    }
+
+    return pos;
+}
+
+
+UVW_INLINE DispatchServer::DispatchServer(Callback cb, std::size_t count, Policy mode)
+    : LoopGroup{count}, callback{std::move(cb)}, policy{mode}, acceptor{}, channels{}, next{}
+{}
+
+
+UVW_INLINE DispatchServer::~DispatchServer() noexcept {
+    stop();
+}
+
+
+UVW_INLINE bool DispatchServer::start(const sockaddr &addr) {
+    if(busy() || acceptor.loop) {
+        // already running
+        return false;
+    }
+
+    bool ok = prepare(acceptor);
+    auto listener = ok ? acceptor.loop->resource<TCPHandle>() : nullptr;
+    channels = std::vector<Channel>(workers.size());
+
+    ok = ok && listener != nullptr;
+
+    if(ok) {
+        auto conn = listener->on<ErrorEvent>([&ok](const auto &, auto &) { ok = false; });
+        listener->bind(addr);
+
+        if(ok) {
+            listener->listen();
+        }
+
+        listener->erase(conn);
+    }
+
+    for(auto pos = 0u; pos < workers.size() && ok; ++pos) {
+        auto &worker = *(workers[pos] = std::make_unique<Worker>());
+        ok = prepare(worker) && setup(worker, channels[pos]);
+    }
+
+    if(ok) {
+        listener->on<ListenEvent>([this](const ListenEvent &, TCPHandle &handle) {
+            // uv_write2 requires at least a byte of data along with the handle
+            static char token[] = { 'x' };
+            auto client = handle.loop().resource<TCPHandle>();
+
+            if(client) {
+                handle.accept(*client);
+
+                if(client->readable()) {
+                    const auto pos = pick();
+                    auto &channel = channels[pos];
+                    ++workers[pos]->connections;
+                    channel.queue.push_back(client);
+                    channel.sending = true;
+                    channel.pipe->write(*client, token, 1u);
+                    channel.sending = false;
+                } else {
+                    client->close();
+                }
+            }
+        });
+    }
+
+    for(auto pos = 0u; pos < workers.size() && ok; ++pos) {
+        ok = launch(*workers[pos], pos);
+    }
+
+    // the acceptor comes last, workers are ready to receive connections
+    ok = ok && launch(acceptor, workers.size());
+
+    if(!ok) {
+        stop();
+    }
+
+    return ok;
+}
+
+
+template<typename I>
+UVW_INLINE bool DispatchServer::start(const std::string &ip, unsigned int port) {
+    typename details::IpTraits<I>::Type addr;
+    details::IpTraits<I>::addrFunc(ip.data(), port, &addr);
+    return start(reinterpret_cast<const sockaddr &>(addr));
+}
+
+
+template<typename I>
+UVW_INLINE bool DispatchServer::start(Addr addr) {
+    return start<I>(std::move(addr.ip), addr.port);
+}
+
+
+UVW_INLINE void DispatchServer::stop() noexcept {
+    // no more connections are dispatched once the acceptor is gone
+    signal(acceptor);
+    release(acceptor);
+    channels.clear();
+    halt();
+}
+
+
+// explicit instantiations
+#ifdef UVW_AS_LIB
+template bool ReusePortServer::start<IPv4>(const std::string &, unsigned int);
+template bool ReusePortServer::start<IPv6>(const std::string &, unsigned int);
+
+template bool ReusePortServer::start<IPv4>(Addr);
+template bool ReusePortServer::start<IPv6>(Addr);
+
+template bool DispatchServer::start<IPv4>(const std::string &, unsigned int);
+template bool DispatchServer::start<IPv6>(const std::string &, unsigned int);
+
+template bool DispatchServer::start<IPv4>(Addr);
+template bool DispatchServer::start<IPv6>(Addr);
+#endif // UVW_AS_LIB
+
+
+}
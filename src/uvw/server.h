@@ -0,0 +1,276 @@
+#ifndef UVW_SERVER_INCLUDE_H
+#define UVW_SERVER_INCLUDE_H
+
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <uv.h>
+#include "async.h"
+#include "function.hpp"
+#include "loop.h"
+#include "pipe.h"
+#include "tcp.h"
+#include "thread.h"
+#include "util.h"
+
+
+namespace uvw {
+
+
+namespace details {
+
+
+class LoopGroup {
+protected:
+    struct Worker {
+        std::shared_ptr<Loop> loop;
+        std::shared_ptr<AsyncHandle> async;
+        std::shared_ptr<Thread> thread;
+        std::atomic<std::size_t> connections{};
+        std::atomic<std::size_t> accepted{};
+        bool running{};
+    };
+
+    static void pin(std::size_t cpu) noexcept;
+
+    static bool prepare(Worker &worker);
+    static bool launch(Worker &worker, std::size_t cpu);
+    static void signal(Worker &worker) noexcept;
+    static void release(Worker &worker) noexcept;
+
+    explicit LoopGroup(std::size_t count);
+
+    bool busy() const noexcept;
+    void halt() noexcept;
+
+public:
+    LoopGroup(const LoopGroup &) = delete;
+    LoopGroup(LoopGroup &&) = delete;
+
+    LoopGroup & operator=(const LoopGroup &) = delete;
+    LoopGroup & operator=(LoopGroup &&) = delete;
+
+    /**
+     * @brief Gets the number of worker loops of the server.
+     * @return The number of worker loops of the server.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Gets the number of open connections of a worker loop.
+     * @param pos The index of the worker loop, less than `size()`.
+     * @return The number of open connections of the worker loop.
+     */
+    std::size_t connections(std::size_t pos) const noexcept;
+
+    /**
+     * @brief Gets the number of connections accepted by a worker loop.
+     * @param pos The index of the worker loop, less than `size()`.
+     * @return The number of connections accepted by the worker loop.
+     */
+    std::size_t accepted(std::size_t pos) const noexcept;
+
+protected:
+    std::vector<std::unique_ptr<Worker>> workers;
+};
+
+
+}
+
+
+/**
+ * @brief Multi-loop TCP server built on top of `SO_REUSEPORT`.
+ *
+ * The server runs a loop per thread, one per core by default, each one of
+ * them with its own listening socket bound to the same address. The kernel
+ * balances the incoming connections between the sockets.<br/>
+ * Threads are pinned to the cores on Linux.
+ *
+ * Accepted connections are handed to a callback on the thread of the loop to
+ * which they belong. The callback is shared by all the loops, therefore it
+ * must be thread-safe.
+ *
+ * `SO_REUSEPORT` isn't available on all the platforms. The server fails to
+ * start where it's not supported.
+ */
+class ReusePortServer final: public details::LoopGroup {
+    bool setup(Worker &worker, const sockaddr &addr);
+
+public:
+    using Callback = Function<void(TCPHandle &)>;
+
+    /**
+     * @brief Constructs a server.
+     * @param cb The callback invoked for each accepted connection.
+     * @param count The number of loops, zero means one per core.
+     */
+    explicit ReusePortServer(Callback cb, std::size_t count = 0u);
+
+    /*! @brief Stops the server, if running. */
+    ~ReusePortServer() noexcept;
+
+    /**
+     * @brief Starts the server.
+     * @param addr Initialized `sockaddr_in` or `sockaddr_in6` data structure.
+     * @return True in case of success, false otherwise.
+     */
+    bool start(const sockaddr &addr);
+
+    /**
+     * @brief Starts the server.
+     * @param ip The address to which to bind.
+     * @param port The port to which to bind.
+     * @return True in case of success, false otherwise.
+     */
+    template<typename I = IPv4>
+    bool start(const std::string &ip, unsigned int port);
+
+    /**
+     * @brief Starts the server.
+     * @param addr A valid instance of Addr.
+     * @return True in case of success, false otherwise.
+     */
+    template<typename I = IPv4>
+    bool start(Addr addr);
+
+    /**
+     * @brief Stops the server.
+     *
+     * All the handles of the loops, accepted connections included, are
+     * closed and the threads are joined.
+     */
+    void stop() noexcept;
+
+private:
+    Callback callback;
+};
+
+
+/**
+ * @brief Multi-loop TCP server that dispatches connections to workers.
+ *
+ * The server runs an acceptor loop and a number of worker loops, one per
+ * core by default, each one on its own thread. Connections are accepted by
+ * the acceptor and sent to the workers over IPC pipes (see
+ * `StreamHandle::write(S &send, ...)` and `PipeHandle::receive()`).<br/>
+ * It's an alternative to ReusePortServer for when the kernel doesn't spread
+ * the connections evenly. Threads are pinned to the cores on Linux.
+ *
+ * Connections are handed to a callback on the thread of the loop to which
+ * they're sent. The callback is shared by all the loops, therefore it must be
+ * thread-safe.
+ *
+ * Handles can be passed only over Unix domain sockets, the server fails to
+ * start on Windows.
+ */
+class DispatchServer final: public details::LoopGroup {
+    struct Channel {
+        std::shared_ptr<PipeHandle> pipe;
+        std::deque<std::shared_ptr<TCPHandle>> queue;
+        bool sending;
+    };
+
+    bool setup(Worker &worker, Channel &channel);
+    std::size_t pick() noexcept;
+
+public:
+    /*! @brief Policies to distribute the connections. */
+    enum class Policy {
+        ROUND_ROBIN,
+        LEAST_CONNECTIONS
+    };
+
+    using Callback = Function<void(TCPHandle &)>;
+
+    /**
+     * @brief Constructs a server.
+     * @param cb The callback invoked for each accepted connection.
+     * @param count The number of worker loops, zero means one per core.
+     * @param mode The policy used to distribute the connections.
+     */
+    explicit DispatchServer(Callback cb, std::size_t count = 0u, Policy mode = Policy::LEAST_CONNECTIONS);
+
+    /*! @brief Stops the server, if running. */
+    ~DispatchServer() noexcept;
+
+    /**
+     * @brief Starts the server.
+     * @param addr Initialized `sockaddr_in` or `sockaddr_in6` data structure.
+     * @return True in case of success, false otherwise.
+     */
+    bool start(const sockaddr &addr);
+
+    /**
+     * @brief Starts the server.
+     * @param ip The address to which to bind.
+     * @param port The port to which to bind.
+     * @return True in case of success, false otherwise.
+     */
+    template<typename I = IPv4>
+    bool start(const std::string &ip, unsigned int port);
+
+    /**
+     * @brief Starts the server.
+     * @param addr A valid instance of Addr.
+     * @return True in case of success, false otherwise.
+     */
+    template<typename I = IPv4>
+    bool start(Addr addr);
+
+    /**
+     * @brief Stops the server.
+     *
+     * All the handles of the loops, accepted connections included, are
+     * closed and the threads are joined.
+     */
+    void stop() noexcept;
+
+private:
+    Callback callback;
+    Policy policy;
+    Worker acceptor;
+    std::vector<Channel> channels;
+    std::size_t next;
+};
+
+
+/**
+ * @cond TURN_OFF_DOXYGEN
+ * Internal details not to be documented.
+ */
+
+
+// (extern) explicit instantiations
+#ifdef UVW_AS_LIB
+extern template bool ReusePortServer::start<IPv4>(const std::string &, unsigned int);
+extern template bool ReusePortServer::start<IPv6>(const std::string &, unsigned int);
+
+extern template bool ReusePortServer::start<IPv4>(Addr);
+extern template bool ReusePortServer::start<IPv6>(Addr);
+
+extern template bool DispatchServer::start<IPv4>(const std::string &, unsigned int);
+extern template bool DispatchServer::start<IPv6>(const std::string &, unsigned int);
+
+extern template bool DispatchServer::start<IPv4>(Addr);
+extern template bool DispatchServer::start<IPv6>(Addr);
+#endif // UVW_AS_LIB
+
+
+/**
+ * Internal details not to be documented.
+ * @endcond
+ */
+
+
+}
+
+
+#ifndef UVW_AS_LIB
+#include "server.cpp"
+#endif
+
+#endif // UVW_SERVER_INCLUDE_H
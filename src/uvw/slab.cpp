@@ -0,0 +1,95 @@
+#ifdef UVW_AS_LIB
+#include "slab.h"
+#endif
+
+#include <utility>
+
+#include "config.h"
+
+
+namespace uvw {
+
+
+UVW_INLINE SlabPool::~SlabPool() noexcept {
+    for(auto *slab: slabs) {
+        details::deallocate(slab);
+    }
+}
+
+
+UVW_INLINE void SlabPool::detach() noexcept {
+    bool orphan = false;
+
+    {
+        std::lock_guard<std::mutex> guard{mutex};
+        detached = true;
+        orphan = !info.used;
+    }
+
+    // blocks still in use will take care of the pool
+    if(orphan) {
+        delete this;
+    }
+}
+
+
+UVW_INLINE void * SlabPool::allocate(std::size_t size) {
+    const auto block = (size + ALIGN - 1u) / ALIGN * ALIGN;
+    std::lock_guard<std::mutex> guard{mutex};
+
+    if(!info.size) {
+        info.size = block;
+    }
+
+    if(block != info.size) {
+        return details::allocate(size);
+    }
+
+    if(!free) {
+        auto *slab = static_cast<char *>(details::allocate(BLOCKS * block));
+        slabs.push_back(slab);
+
+        for(auto next = BLOCKS; next; --next) {
+            free = new (slab + (next - 1u) * block) Block{free};
+        }
+
+        info.capacity += BLOCKS;
+        ++info.slabs;
+    }
+
+    ++info.used;
+
+    return std::exchange(free, free->next);
+}
+
+
+UVW_INLINE void SlabPool::deallocate(void *ptr, std::size_t size) noexcept {
+    const auto block = (size + ALIGN - 1u) / ALIGN * ALIGN;
+    bool orphan = false;
+
+    {
+        std::lock_guard<std::mutex> guard{mutex};
+
+        if(block != info.size) {
+            details::deallocate(ptr);
+            return;
+        }
+
+        free = new (ptr) Block{free};
+        --info.used;
+        orphan = detached && !info.used;
+    }
+
+    if(orphan) {
+        delete this;
+    }
+}
+
+
+UVW_INLINE SlabPool::Stats SlabPool::stats() const noexcept {
+    std::lock_guard<std::mutex> guard{mutex};
+    return info;
+}
+
+
+}
@@ -0,0 +1,152 @@
+#ifndef UVW_SLAB_INCLUDE_H
+#define UVW_SLAB_INCLUDE_H
+
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "allocator.h"
+
+
+namespace uvw {
+
+
+/**
+ * @brief Fixed size blocks carved out of larger slabs.
+ *
+ * Loops can own a pool for each type of resource, so that resources of the
+ * same type are packed together and their memory is reused once they go
+ * away.<br/>
+ * The size of the blocks is set by the first allocation, requests of any
+ * other size are served directly from the heap.<br/>
+ * Blocks can safely be released from any thread and can outlive the loop
+ * that created them. Slabs are freed along with the pool.
+ */
+class SlabPool final {
+    friend class Loop;
+
+    struct Block {
+        Block *next;
+    };
+
+    static constexpr std::size_t ALIGN = alignof(std::max_align_t);
+    static constexpr std::size_t BLOCKS = 64u;
+
+    SlabPool() noexcept = default;
+    ~SlabPool() noexcept;
+
+    void detach() noexcept;
+
+public:
+    /*! @brief Statistics about the pool. */
+    struct Stats {
+        std::size_t size; /*!< Size of the blocks, in bytes. */
+        std::size_t slabs; /*!< Slabs allocated so far. */
+        std::size_t capacity; /*!< Blocks available in the slabs. */
+        std::size_t used; /*!< Blocks currently handed out. */
+    };
+
+    SlabPool(const SlabPool &) = delete;
+    SlabPool(SlabPool &&) = delete;
+
+    SlabPool & operator=(const SlabPool &) = delete;
+    SlabPool & operator=(SlabPool &&) = delete;
+
+    /**
+     * @brief Gets a block from the pool.
+     * @param size The size of the block, in bytes.
+     * @return A pointer to a suitably aligned block.
+     */
+    void * allocate(std::size_t size);
+
+    /**
+     * @brief Gives a block back to the pool.
+     * @param ptr A block obtained from the pool.
+     * @param size The size used to obtain the block, in bytes.
+     */
+    void deallocate(void *ptr, std::size_t size) noexcept;
+
+    /**
+     * @brief Gets the statistics of the pool.
+     * @return A snapshot of the statistics of the pool.
+     */
+    Stats stats() const noexcept;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<void *> slabs{};
+    Block *free{};
+    Stats info{};
+    bool detached{false};
+};
+
+
+/**
+ * @brief Standard allocator that draws from a pool of slabs.
+ *
+ * It's meant to be used with `std::allocate_shared`, the object and its
+ * control block end up in the same block.
+ */
+template<typename T>
+class SlabAllocator final {
+    template<typename>
+    friend class SlabAllocator;
+
+public:
+    using value_type = T;
+
+    /**
+     * @brief Constructs an allocator for the given pool.
+     * @param ref A pool that outlives the allocations.
+     */
+    explicit SlabAllocator(SlabPool &ref) noexcept
+        : pool{&ref}
+    {}
+
+    template<typename U>
+    SlabAllocator(const SlabAllocator<U> &other) noexcept
+        : pool{other.pool}
+    {}
+
+    T * allocate(std::size_t n) {
+        if constexpr(alignof(T) > alignof(std::max_align_t)) {
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        } else {
+            return static_cast<T *>(n == 1u ? pool->allocate(sizeof(T)) : details::allocate(n * sizeof(T)));
+        }
+    }
+
+    void deallocate(T *ptr, std::size_t n) noexcept {
+        if constexpr(alignof(T) > alignof(std::max_align_t)) {
+            ::operator delete(ptr, std::align_val_t{alignof(T)});
+        } else if(n == 1u) {
+            pool->deallocate(ptr, sizeof(T));
+        } else {
+            details::deallocate(ptr);
+        }
+    }
+
+    template<typename U>
+    bool operator==(const SlabAllocator<U> &other) const noexcept {
+        return pool == other.pool;
+    }
+
+    template<typename U>
+    bool operator!=(const SlabAllocator<U> &other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    SlabPool *pool;
+};
+
+
+}
+
+
+#ifndef UVW_AS_LIB
+#include "slab.cpp"
+#endif
+
+#endif // UVW_SLAB_INCLUDE_H
@@ -8,7 +8,7 @@
 namespace uvw {
 
 
-UVW_INLINE DataEvent::DataEvent(std::unique_ptr<char[]> buf, std::size_t len) noexcept
+UVW_INLINE DataEvent::DataEvent(std::unique_ptr<char[], BufferDeleter> buf, std::size_t len) noexcept
     : data{std::move(buf)}, length{len}
 {}
 
@@ -18,4 +18,65 @@ UVW_INLINE void details::ShutdownReq::shutdown(uv_stream_t *handle) {
 }
 
 
+UVW_INLINE details::BufferArray::BufferArray(const std::vector<Buffer> &bufs)
+    : local{}, heap{}, count{static_cast<unsigned int>(bufs.size())}
+{
+    uv_buf_t *dst = local;
+
+    if(!count) {
+        // libuv refuses empty arrays, an empty buffer has the same effect
+        local[0u] = uv_buf_init(nullptr, 0u);
+        count = 1u;
+    }
+
+    if(count > SIZE) {
+        heap = details::allocateUnique<uv_buf_t[]>(count);
+        dst = heap.get();
+    }
+
+    for(auto &&buf: bufs) {
+        *(dst++) = uv_buf_init(buf.data.get(), buf.length);
+    }
+}
+
+
+UVW_INLINE const uv_buf_t * details::BufferArray::data() const noexcept {
+    return heap ? heap.get() : local;
+}
+
+
+UVW_INLINE unsigned int details::BufferArray::size() const noexcept {
+    return count;
+}
+
+
+UVW_INLINE details::WritevReq::WritevReq(ConstructorAccess ca, std::shared_ptr<Loop> loop, std::vector<Buffer> bufs)
+    : Request<WritevReq, uv_write_t>{ca, std::move(loop)},
+      data{std::move(bufs)}
+{}
+
+
+UVW_INLINE void details::WritevReq::assign(std::vector<Buffer> bufs) noexcept {
+    data = std::move(bufs);
+}
+
+
+UVW_INLINE void details::WritevReq::discard() noexcept {
+    data.clear();
+}
+
+
+UVW_INLINE void details::WritevReq::write(uv_stream_t *handle) {
+    // libuv copies the array of buffers, it needn't to outlive the call
+    details::BufferArray bufs{data};
+    invoke(&uv_write, get(), handle, bufs.data(), bufs.size(), &defaultCallback<WriteEvent>);
+}
+
+
+UVW_INLINE void details::WritevReq::write(uv_stream_t *handle, uv_stream_t *send) {
+    details::BufferArray bufs{data};
+    invoke(&uv_write2, get(), handle, bufs.data(), bufs.size(), send, &defaultCallback<WriteEvent>);
+}
+
+
 }
@@ -5,12 +5,18 @@
 #include <algorithm>
 #include <iterator>
 #include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <memory>
+#include <type_traits>
+#include <vector>
 #include <uv.h>
+#include "buffer.h"
 #include "request.hpp"
 #include "handle.hpp"
+#include "check.h"
 #include "loop.h"
+#include "prepare.h"
 
 
 namespace uvw {
@@ -40,6 +46,17 @@ struct EndEvent {};
 struct ListenEvent {};
 
 
+/**
+ * @brief AcceptEvent event.
+ *
+ * It will be emitted by StreamHandle according with its functionalities.
+ */
+template<typename T>
+struct AcceptEvent {
+    std::vector<std::shared_ptr<T>> handles; /*!< The accepted connections. */
+};
+
+
 /**
  * @brief ShutdownEvent event.
  *
@@ -56,15 +73,43 @@ struct ShutdownEvent {};
 struct WriteEvent {};
 
 
+/**
+ * @brief PressureEvent event.
+ *
+ * It will be emitted by StreamHandle according with its functionalities.
+ */
+struct PressureEvent {};
+
+
+/**
+ * @brief DrainEvent event.
+ *
+ * It will be emitted by StreamHandle according with its functionalities.
+ */
+struct DrainEvent {};
+
+
+/**
+ * @brief Counters of a relay between two streams.
+ *
+ * They're updated by StreamHandle according with its functionalities.
+ */
+struct RelayInfo {
+    std::uint64_t bytes{}; /*!< Bytes forwarded to the destination. */
+    std::uint64_t chunks{}; /*!< Buffers forwarded to the destination. */
+    std::uint64_t pauses{}; /*!< Times reading was paused by backpressure. */
+};
+
+
 /**
  * @brief DataEvent event.
  *
  * It will be emitted by StreamHandle according with its functionalities.
  */
 struct DataEvent {
-    explicit DataEvent(std::unique_ptr<char[]> buf, std::size_t len) noexcept;
+    explicit DataEvent(std::unique_ptr<char[], BufferDeleter> buf, std::size_t len) noexcept;
 
-    std::unique_ptr<char[]> data; /*!< A bunch of data read on the stream. */
+    std::unique_ptr<char[], BufferDeleter> data; /*!< A bunch of data read on the stream. */
     std::size_t length; /*!< The amount of data read on the stream. */
 };
 
@@ -73,7 +118,14 @@ namespace details {
 
 
 struct ConnectReq final: public Request<ConnectReq, uv_connect_t> {
+    static constexpr bool RECYCLABLE = true;
+
     using Request::Request;
+    using Request::acquire;
+    using Request::completion;
+
+    void assign() noexcept {}
+    void discard() noexcept {}
 
     template<typename F, typename... Args>
     void connect(F &&f, Args&&... args) {
@@ -83,7 +135,14 @@ struct ConnectReq final: public Request<ConnectReq, uv_connect_t> {
 
 
 struct ShutdownReq final: public Request<ShutdownReq, uv_shutdown_t> {
+    static constexpr bool RECYCLABLE = true;
+
     using Request::Request;
+    using Request::acquire;
+    using Request::completion;
+
+    void assign() noexcept {}
+    void discard() noexcept {}
 
     void shutdown(uv_stream_t *handle);
 };
@@ -94,12 +153,28 @@ class WriteReq final: public Request<WriteReq<Deleter>, uv_write_t> {
     using ConstructorAccess = typename Request<WriteReq<Deleter>, uv_write_t>::ConstructorAccess;
 
 public:
+    // deleters like lambdas can't be replaced, requests that use them aren't reused
+    static constexpr bool RECYCLABLE = std::is_move_assignable_v<std::unique_ptr<char[], Deleter>>;
+
+    using Request<WriteReq<Deleter>, uv_write_t>::acquire;
+    using Request<WriteReq<Deleter>, uv_write_t>::completion;
+
     WriteReq(ConstructorAccess ca, std::shared_ptr<Loop> loop, std::unique_ptr<char[], Deleter> dt, unsigned int len)
         : Request<WriteReq<Deleter>, uv_write_t>{ca, std::move(loop)},
           data{std::move(dt)},
           buf{uv_buf_init(data.get(), len)}
     {}
 
+    void assign(std::unique_ptr<char[], Deleter> dt, unsigned int len) noexcept {
+        data = std::move(dt);
+        buf = uv_buf_init(data.get(), len);
+    }
+
+    void discard() noexcept {
+        data.reset();
+        buf = uv_buf_init(nullptr, 0u);
+    }
+
     void write(uv_stream_t *handle) {
         this->invoke(&uv_write, this->get(), handle, &buf, 1, &this->template defaultCallback<WriteEvent>);
     }
@@ -114,6 +189,45 @@ private:
 };
 
 
+class BufferArray final {
+    static constexpr std::size_t SIZE = 16u;
+
+public:
+    explicit BufferArray(const std::vector<Buffer> &bufs);
+
+    BufferArray(const BufferArray &) = delete;
+    BufferArray & operator=(const BufferArray &) = delete;
+
+    const uv_buf_t * data() const noexcept;
+    unsigned int size() const noexcept;
+
+private:
+    uv_buf_t local[SIZE];
+    details::AllocatorPtr<uv_buf_t[]> heap;
+    unsigned int count;
+};
+
+
+class WritevReq final: public Request<WritevReq, uv_write_t> {
+public:
+    static constexpr bool RECYCLABLE = true;
+
+    using Request::acquire;
+    using Request::completion;
+
+    WritevReq(ConstructorAccess ca, std::shared_ptr<Loop> loop, std::vector<Buffer> bufs);
+
+    void assign(std::vector<Buffer> bufs) noexcept;
+    void discard() noexcept;
+
+    void write(uv_stream_t *handle);
+    void write(uv_stream_t *handle, uv_stream_t *send);
+
+private:
+    std::vector<Buffer> data;
+};
+
+
 }
 
 
@@ -127,11 +241,30 @@ private:
 template<typename T, typename U>
 class StreamHandle: public Handle<T, U> {
     static constexpr unsigned int DEFAULT_BACKLOG = 128;
+    static constexpr std::size_t DEFAULT_THRESHOLD = 64u * 1024u;
+    static constexpr std::size_t DEFAULT_HWM = 64u * 1024u;
+    static constexpr std::size_t DEFAULT_LWM = 16u * 1024u;
+
+    struct Batch {
+        std::shared_ptr<PrepareHandle> hook;
+        std::vector<Buffer> bufs;
+        std::size_t bytes;
+        std::size_t writes;
+        std::size_t threshold;
+    };
+
+    struct Acceptor {
+        std::shared_ptr<CheckHandle> hook;
+        std::vector<std::shared_ptr<T>, details::AllocatorAdapter<std::shared_ptr<T>>> spare;
+        // handed over as is with AcceptEvent events
+        std::vector<std::shared_ptr<T>> ready;
+        std::size_t size;
+    };
 
     static void readCallback(uv_stream_t *handle, ssize_t nread, const uv_buf_t *buf) {
         T &ref = *(static_cast<T*>(handle->data));
         // data will be destroyed no matter of what the value of nread is
-        std::unique_ptr<char[]> data{buf->base};
+        auto data = ref.acquire(buf->base);
 
         // nread == 0 is ignored (see http://docs.libuv.org/en/v1.x/stream.html)
         // equivalent to EAGAIN/EWOULDBLOCK, it shouldn't be treated as an error
@@ -151,7 +284,9 @@ class StreamHandle: public Handle<T, U> {
 
     static void listenCallback(uv_stream_t *handle, int status) {
         T &ref = *(static_cast<T*>(handle->data));
+        StreamHandle &stream = ref;
         if(status) { ref.publish(ErrorEvent{status}); }
+        else if(stream.acceptor) { stream.collect(); }
         else { ref.publish(ListenEvent{}); }
     }
 
@@ -164,6 +299,36 @@ public:
     using Handle<T, U>::Handle;
 #endif
 
+    ~StreamHandle() noexcept {
+        if(batch) {
+            batch->hook->close();
+        }
+
+        if(acceptor) {
+            dropAcceptor();
+        }
+    }
+
+    /**
+     * @brief Request handle to be closed.
+     *
+     * A corked stream is uncorked first, so that queued writes are submitted
+     * before the stream is closed as if it wasn't corked. Handles created in
+     * advance for batch accept and not delivered yet, if any, are closed along
+     * with the stream.<br/>
+     * See `Handle::close()` for further details.
+     */
+    void close() noexcept {
+        uncork();
+
+        if(acceptor) {
+            dropAcceptor();
+            acceptor.reset();
+        }
+
+        Handle<T, U>::close();
+    }
+
     /**
      * @brief Shutdowns the outgoing (write) side of a duplex stream.
      *
@@ -172,13 +337,10 @@ public:
      * A ShutdownEvent event will be emitted after shutdown is complete.
      */
     void shutdown() {
-        auto listener = [ptr = this->shared_from_this()](const auto &event, const auto &) {
-            ptr->publish(event);
-        };
+        flush();
 
-        auto shutdown = this->loop().template resource<details::ShutdownReq>();
-        shutdown->template once<ErrorEvent>(listener);
-        shutdown->template once<ShutdownEvent>(listener);
+        auto shutdown = details::ShutdownReq::acquire(this->loop());
+        shutdown->completion(this->template relay<ShutdownEvent>());
         shutdown->shutdown(this->template get<uv_stream_t>());
     }
 
@@ -186,7 +348,7 @@ public:
      * @brief Starts listening for incoming connections.
      *
      * When a new incoming connection is received, a ListenEvent event is
-     * emitted.<br/>
+     * emitted, unless batch accept is enabled (see `batchAccept()`).<br/>
      * An ErrorEvent event will be emitted in case of errors.
      *
      * @param backlog Indicates the number of connections the kernel might
@@ -220,6 +382,52 @@ public:
         this->invoke(&uv_accept, this->template get<uv_stream_t>(), this->template get<uv_stream_t>(ref));
     }
 
+    /**
+     * @brief Enables batch accept.
+     *
+     * Incoming connections are accepted on behalf of the user into handles
+     * created in advance and delivered with a single AcceptEvent event, either
+     * as soon as the batch is full or right after the loop has polled for I/O.
+     * No ListenEvent events are emitted in this mode.<br/>
+     * Accepted handles belong to the user, the same as any other handle
+     * created through the loop. Handles created in advance and not used yet
+     * are closed along with the stream, when `close()` is invoked on it.
+     *
+     * Enabling batch accept on a stream that already has it updates the size
+     * of the batch, a size equal to zero disables it.
+     *
+     * @param size The maximum number of connections per batch.
+     */
+    void batchAccept(std::size_t size) {
+        if(!size) {
+            if(acceptor) {
+                // pending connections are delivered, no more handles are created
+                acceptor->size = 0u;
+                dispatch();
+
+                // listeners can close the stream and drop the acceptor
+                if(acceptor) {
+                    dropAcceptor();
+                    acceptor.reset();
+                }
+            }
+        } else {
+            if(!acceptor) {
+                auto hook = this->loop().template resource<CheckHandle>();
+
+                if(!hook) {
+                    return;
+                }
+
+                hook->template on<CheckEvent>([this](const auto &, auto &) { dispatch(); });
+                acceptor = details::allocateUnique<Acceptor>(Acceptor{std::move(hook), {}, {}, size});
+            }
+
+            acceptor->size = size;
+            refill();
+        }
+    }
+
     /**
      * @brief Starts reading data from an incoming stream.
      *
@@ -231,6 +439,20 @@ public:
         this->invoke(&uv_read_start, this->template get<uv_stream_t>(), &this->allocCallback, &readCallback);
     }
 
+    /**
+     * @brief Sets the allocator used to get the buffers to read into.
+     *
+     * By default, buffers are drawn from the pool of the loop. A custom
+     * allocator can provide smaller buffers or buffers that belong to a
+     * protocol specific structure, the deleter of which is propagated to
+     * `DataEvent::data`. An empty allocator restores the default behavior.
+     *
+     * @param alloc A buffer allocator, possibly empty.
+     */
+    void allocator(BufferAllocator alloc) noexcept {
+        Handle<T, U>::allocator(std::move(alloc));
+    }
+
     /**
      * @brief Stops reading data from the stream.
      *
@@ -254,14 +476,20 @@ public:
      */
     template<typename Deleter>
     void write(std::unique_ptr<char[], Deleter> data, unsigned int len) {
-        auto req = this->loop().template resource<details::WriteReq<Deleter>>(std::move(data), len);
-        auto listener = [ptr = this->shared_from_this()](const auto &event, const auto &) {
-            ptr->publish(event);
-        };
+        if constexpr(std::is_convertible_v<Deleter, BufferDeleter>) {
+            if(batch) {
+                push(Buffer{std::unique_ptr<char[], BufferDeleter>{std::move(data)}, len});
+                return commit();
+            }
+        }
+
+        // deleters that don't fit a buffer bypass the batch, order is preserved
+        flush();
 
-        req->template once<ErrorEvent>(listener);
-        req->template once<WriteEvent>(listener);
+        auto req = details::WriteReq<Deleter>::acquire(this->loop(), std::move(data), len);
+        forward(*req, 1u);
         req->write(this->template get<uv_stream_t>());
+        pressure();
     }
 
     /**
@@ -277,14 +505,42 @@ public:
      * @param len The lenght of the submitted data.
      */
     void write(char *data, unsigned int len) {
-        auto req = this->loop().template resource<details::WriteReq<void(*)(char *)>>(std::unique_ptr<char[], void(*)(char *)>{data, [](char *) {}}, len);
-        auto listener = [ptr = this->shared_from_this()](const auto &event, const auto &) {
-            ptr->publish(event);
-        };
+        if(batch) {
+            push(Buffer{data, len});
+            return commit();
+        }
+
+        auto req = details::WriteReq<void(*)(char *)>::acquire(this->loop(), std::unique_ptr<char[], void(*)(char *)>{data, [](char *) {}}, len);
+        forward(*req, 1u);
+        req->write(this->template get<uv_stream_t>());
+        pressure();
+    }
+
+    /**
+     * @brief Writes a sequence of buffers to the stream.
+     *
+     * Buffers are submitted all together by means of a single write request
+     * and written in order. The handle takes the ownership of the buffers and
+     * releases them according to their deleters.
+     *
+     * A WriteEvent event will be emitted when the data have been written.<br/>
+     * An ErrorEvent event will be emitted in case of errors.
+     *
+     * @param bufs The buffers to be written to the stream.
+     */
+    void write(std::vector<Buffer> bufs) {
+        if(batch) {
+            for(auto &&buf: bufs) {
+                push(std::move(buf));
+            }
+
+            return commit();
+        }
 
-        req->template once<ErrorEvent>(listener);
-        req->template once<WriteEvent>(listener);
+        auto req = details::WritevReq::acquire(this->loop(), std::move(bufs));
+        forward(*req, 1u);
         req->write(this->template get<uv_stream_t>());
+        pressure();
     }
 
     /**
@@ -308,14 +564,12 @@ public:
      */
     template<typename S, typename Deleter>
     void write(S &send, std::unique_ptr<char[], Deleter> data, unsigned int len) {
-        auto req = this->loop().template resource<details::WriteReq<Deleter>>(std::move(data), len);
-        auto listener = [ptr = this->shared_from_this()](const auto &event, const auto &) {
-            ptr->publish(event);
-        };
+        flush();
 
-        req->template once<ErrorEvent>(listener);
-        req->template once<WriteEvent>(listener);
+        auto req = details::WriteReq<Deleter>::acquire(this->loop(), std::move(data), len);
+        forward(*req, 1u);
         req->write(this->template get<uv_stream_t>(), this->template get<uv_stream_t>(send));
+        pressure();
     }
 
     /**
@@ -339,14 +593,41 @@ public:
      */
     template<typename S>
     void write(S &send, char *data, unsigned int len) {
-        auto req = this->loop().template resource<details::WriteReq<void(*)(char *)>>(std::unique_ptr<char[], void(*)(char *)>{data, [](char *) {}}, len);
-        auto listener = [ptr = this->shared_from_this()](const auto &event, const auto &) {
-            ptr->publish(event);
-        };
+        flush();
+
+        auto req = details::WriteReq<void(*)(char *)>::acquire(this->loop(), std::unique_ptr<char[], void(*)(char *)>{data, [](char *) {}}, len);
+        forward(*req, 1u);
+        req->write(this->template get<uv_stream_t>(), this->template get<uv_stream_t>(send));
+        pressure();
+    }
+
+    /**
+     * @brief Extended write function for sending handles over a pipe handle.
+     *
+     * The pipe must be initialized with `ipc == true`.
+     *
+     * `send` must be a TCPHandle or PipeHandle handle, which is a server or a
+     * connection (listening or connected state). Bound sockets or pipes will be
+     * assumed to be servers.
+     *
+     * Buffers are submitted all together by means of a single write request.
+     * The handle takes the ownership of the buffers and releases them
+     * according to their deleters.
+     *
+     * A WriteEvent event will be emitted when the data have been written.<br/>
+     * An ErrorEvent wvent will be emitted in case of errors.
+     *
+     * @param send The handle over which to write data.
+     * @param bufs The buffers to be written to the stream.
+     */
+    template<typename S>
+    void write(S &send, std::vector<Buffer> bufs) {
+        flush();
 
-        req->template once<ErrorEvent>(listener);
-        req->template once<WriteEvent>(listener);
+        auto req = details::WritevReq::acquire(this->loop(), std::move(bufs));
+        forward(*req, 1u);
         req->write(this->template get<uv_stream_t>(), this->template get<uv_stream_t>(send));
+        pressure();
     }
 
     /**
@@ -360,7 +641,10 @@ public:
      * @param len The lenght of the submitted data.
      * @return Number of bytes written.
      */
-    int tryWrite(std::unique_ptr<char[]> data, unsigned int len) {
+    template<typename Deleter>
+    int tryWrite(std::unique_ptr<char[], Deleter> data, unsigned int len) {
+        flush();
+
         uv_buf_t bufs[] = { uv_buf_init(data.get(), len) };
         auto bw = uv_try_write(this->template get<uv_stream_t>(), bufs, 1);
 
@@ -384,6 +668,8 @@ public:
      * @return Number of bytes written.
      */
     int tryWrite(char *data, unsigned int len) {
+        flush();
+
         uv_buf_t bufs[] = { uv_buf_init(data, len) };
         auto bw = uv_try_write(this->template get<uv_stream_t>(), bufs, 1);
 
@@ -395,6 +681,236 @@ public:
         return bw;
     }
 
+    /**
+     * @brief Queues a write request if it can be completed immediately.
+     *
+     * Same as `write()`, but won’t queue a write request if it can’t be
+     * completed immediately. Buffers are written in order with a single
+     * system call, if the platform supports it.<br/>
+     * An ErrorEvent event will be emitted in case of errors.
+     *
+     * @param bufs The buffers to be written to the stream.
+     * @return Number of bytes written.
+     */
+    int tryWrite(const std::vector<Buffer> &bufs) {
+        flush();
+
+        details::BufferArray array{bufs};
+        auto bw = uv_try_write(this->template get<uv_stream_t>(), array.data(), array.size());
+
+        if(bw < 0) {
+            this->publish(ErrorEvent{bw});
+            bw = 0;
+        }
+
+        return bw;
+    }
+
+    /**
+     * @brief Enables write coalescing.
+     *
+     * While the stream is corked, writes are queued rather than submitted and
+     * flushed as a single vectored write before the loop polls for I/O again,
+     * or as soon as the queued data reach the given threshold.<br/>
+     * A WriteEvent event is still emitted for each one of the writes. Writes
+     * that carry data with a deleter that isn't convertible to BufferDeleter,
+     * as well as extended writes and tries, flush the queue and are submitted
+     * as usual.
+     *
+     * Corking a stream that is already corked updates the threshold.
+     *
+     * @param threshold The amount of queued bytes that triggers a flush.
+     */
+    void cork(std::size_t threshold = DEFAULT_THRESHOLD) {
+        if(!batch) {
+            auto hook = this->loop().template resource<PrepareHandle>();
+
+            if(!hook) {
+                return;
+            }
+
+            hook->template on<PrepareEvent>([this](const auto &, auto &) { flush(); });
+            batch = details::allocateUnique<Batch>(Batch{std::move(hook), {}, 0u, 0u, threshold});
+        }
+
+        batch->threshold = threshold;
+    }
+
+    /**
+     * @brief Disables write coalescing.
+     *
+     * Queued writes, if any, are flushed immediately.
+     */
+    void uncork() {
+        if(batch) {
+            flush();
+            batch->hook->close();
+            batch.reset();
+        }
+    }
+
+    /**
+     * @brief Checks if write coalescing is enabled.
+     * @return True if the stream is corked, false otherwise.
+     */
+    bool corked() const noexcept {
+        return (batch != nullptr);
+    }
+
+    /**
+     * @brief Submits the writes queued while the stream is corked.
+     *
+     * This function is idempotent and may be safely called on a stream that
+     * isn't corked or has nothing to flush.
+     */
+    void flush() {
+        if(batch && batch->writes) {
+            auto count = std::exchange(batch->writes, 0u);
+            auto req = details::WritevReq::acquire(this->loop(), std::exchange(batch->bufs, {}));
+
+            batch->bytes = 0u;
+            batch->hook->stop();
+
+            forward(*req, count);
+            req->write(this->template get<uv_stream_t>());
+        }
+    }
+
+    /**
+     * @brief Sets the water marks of the write queue.
+     *
+     * A PressureEvent event will be emitted when the amount of queued bytes
+     * (including those of a corked stream) reaches the high water mark.<br/>
+     * A DrainEvent event will be emitted when it falls back to the low water
+     * mark after a PressureEvent event.
+     *
+     * A high water mark equal to zero disables both events.
+     *
+     * @param hwm The high water mark, in bytes.
+     * @param lwm The low water mark, in bytes.
+     */
+    void waterMarks(std::size_t hwm, std::size_t lwm) noexcept {
+        high = hwm;
+        low = std::min(lwm, hwm);
+        congested = congested && high;
+    }
+
+    /**
+     * @brief Gets the water marks of the write queue.
+     * @return The high and the low water marks, in bytes.
+     */
+    std::pair<std::size_t, std::size_t> waterMarks() const noexcept {
+        return std::make_pair(high, low);
+    }
+
+    /**
+     * @brief Checks if the write queue is above the high water mark.
+     *
+     * The stream is under pressure from the time a PressureEvent event is
+     * emitted to the time the following DrainEvent event is emitted.
+     *
+     * @return True if the stream is under pressure, false otherwise.
+     */
+    bool pressured() const noexcept {
+        return congested;
+    }
+
+    /**
+     * @brief Forwards the data read from the stream to another stream.
+     *
+     * The stream starts reading and the data are written to the destination
+     * as they arrive, without copies. Reading is paused when the destination
+     * is under pressure and resumed when it's drained. Once the stream
+     * reaches its end, the destination is shut down.<br/>
+     * The listeners of the relay are removed from both the streams when the
+     * stream reaches its end or emits an error. Piping the stream again
+     * replaces the previous relay.<br/>
+     * If the destination has no water marks, they're set to 64 KiB and 16 KiB
+     * respectively.
+     *
+     * @param dst The destination stream.
+     */
+    template<typename S>
+    void pipe(S &dst) {
+        relayTo(dst);
+    }
+
+    /**
+     * @brief Relays the data read from the stream to another stream.
+     *
+     * Same as `pipe()`, but it also keeps track of the traffic.<br/>
+     * Buffers are drawn from the pool of the loop (or the allocator of the
+     * stream) and go back to it as soon as they're written to the
+     * destination, therefore a relay recycles a bunch of buffers rather than
+     * allocating memory for each read.
+     *
+     * Invoke `relayTo()` on both the streams to get a bidirectional relay.
+     *
+     * @param dst The destination stream.
+     * @return The counters of the relay, updated as the data flow.
+     */
+    template<typename S>
+    std::shared_ptr<const RelayInfo> relayTo(S &dst) {
+        if(relayed) {
+            // a relay set up earlier would forward the same data twice
+            unrelay();
+            stop();
+        }
+
+        auto info = std::make_shared<RelayInfo>();
+        std::weak_ptr<T> src = this->shared_from_this();
+
+        if(!dst.waterMarks().first) {
+            dst.waterMarks(DEFAULT_HWM, DEFAULT_LWM);
+        }
+
+        auto pressure = dst.template on<PressureEvent>([src, info](const auto &, auto &) {
+            if(auto ref = src.lock(); ref) {
+                ++info->pauses;
+                ref->stop();
+            }
+        });
+
+        auto drain = dst.template on<DrainEvent>([src](const auto &, auto &) {
+            if(auto ref = src.lock(); ref && !ref->closing()) { ref->read(); }
+        });
+
+        // handles keep themselves alive until closed, weak references avoid cycles
+        std::weak_ptr<S> dest = dst.shared_from_this();
+
+        auto data = this->template on<DataEvent>([dest, info](DataEvent &event, auto &) {
+            if(auto ref = dest.lock(); ref) {
+                info->bytes += event.length;
+                ++info->chunks;
+                ref->write(std::move(event.data), static_cast<unsigned int>(event.length));
+            }
+        });
+
+        auto end = this->template on<EndEvent>([dest](const auto &, auto &ref) {
+            static_cast<StreamHandle &>(ref).unrelay();
+            if(auto other = dest.lock(); other) { other->shutdown(); }
+        });
+
+        auto error = this->template on<ErrorEvent>([](const auto &, auto &ref) {
+            static_cast<StreamHandle &>(ref).unrelay();
+        });
+
+        relayed = [this, dest, pressure, drain, data, end, error]() {
+            this->erase(data);
+            this->erase(end);
+            this->erase(error);
+
+            if(auto ref = dest.lock(); ref) {
+                ref->erase(pressure);
+                ref->erase(drain);
+            }
+        };
+
+        read();
+
+        return info;
+    }
+
     /**
      * @brief Checks if the stream is readable.
      * @return True if the stream is readable, false otherwise.
@@ -437,6 +953,138 @@ public:
     size_t writeQueueSize() const noexcept {
         return uv_stream_get_write_queue_size(this->template get<uv_stream_t>());
     }
+
+private:
+    template<typename R>
+    void forward(R &req, std::size_t count) {
+        req.completion([ptr = this->shared_from_this(), count](int status) {
+            // a flushed batch completes as many writes as it contains
+            for(auto next = count; next; --next) {
+                if(status) { ptr->publish(ErrorEvent{status}); }
+                else { ptr->publish(WriteEvent{}); }
+            }
+
+            ptr->drain();
+        });
+    }
+
+    void collect() {
+        if(acceptor->spare.empty()) {
+            refill();
+        }
+
+        if(acceptor->spare.empty()) {
+            this->publish(ErrorEvent{static_cast<int>(UV_ENOMEM)});
+        } else {
+            auto handle = std::move(acceptor->spare.back());
+            acceptor->spare.pop_back();
+
+            if(auto err = uv_accept(this->template get<uv_stream_t>(), handle->template get<uv_stream_t>()); err) {
+                acceptor->spare.push_back(std::move(handle));
+                this->publish(ErrorEvent{err});
+            } else {
+                acceptor->ready.push_back(std::move(handle));
+
+                if(acceptor->ready.size() >= acceptor->size) {
+                    dispatch();
+                } else if(acceptor->ready.size() == 1u) {
+                    acceptor->hook->start();
+                }
+            }
+        }
+    }
+
+    void dispatch() {
+        acceptor->hook->stop();
+
+        if(!acceptor->ready.empty()) {
+            AcceptEvent<T> event{std::exchange(acceptor->ready, {})};
+            this->publish(std::move(event));
+        }
+
+        // listeners can disable batch accept or close the stream
+        if(acceptor && !this->closing()) {
+            refill();
+        }
+    }
+
+    void refill() {
+        // handles are created in advance, away from the accept path
+        acceptor->ready.reserve(acceptor->size);
+
+        while(acceptor->spare.size() < acceptor->size) {
+            auto handle = this->loop().template resource<T>();
+
+            if(!handle) {
+                break;
+            }
+
+            acceptor->spare.push_back(std::move(handle));
+        }
+    }
+
+    void dropAcceptor() noexcept {
+        acceptor->hook->close();
+
+        for(auto &&handle: acceptor->spare) {
+            handle->close();
+        }
+
+        for(auto &&handle: acceptor->ready) {
+            handle->close();
+        }
+
+        acceptor->spare.clear();
+        acceptor->ready.clear();
+    }
+
+    void unrelay() {
+        if(auto func = std::exchange(relayed, nullptr); func) {
+            func();
+        }
+    }
+
+    std::size_t queued() const noexcept {
+        return writeQueueSize() + (batch ? batch->bytes : 0u);
+    }
+
+    void pressure() {
+        if(high && !congested && queued() >= high) {
+            congested = true;
+            this->publish(PressureEvent{});
+        }
+    }
+
+    void drain() {
+        if(congested && queued() <= low) {
+            congested = false;
+            this->publish(DrainEvent{});
+        }
+    }
+
+    void push(Buffer buf) {
+        batch->bytes += buf.length;
+        batch->bufs.push_back(std::move(buf));
+    }
+
+    void commit() {
+        if(!batch->writes++) {
+            batch->hook->start();
+        }
+
+        if(batch->bytes >= batch->threshold) {
+            flush();
+        } else {
+            pressure();
+        }
+    }
+
+    details::AllocatorPtr<Batch> batch{};
+    details::AllocatorPtr<Acceptor> acceptor{};
+    Function<void()> relayed{};
+    std::size_t high{};
+    std::size_t low{};
+    bool congested{};
 };
 
 
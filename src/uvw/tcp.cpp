@@ -85,13 +85,8 @@ UVW_INLINE void TCPHandle::connect(Addr addr) {
 
 
 UVW_INLINE void TCPHandle::connect(const sockaddr &addr) {
-    auto listener = [ptr = shared_from_this()](const auto &event, const auto &) {
-        ptr->publish(event);
-    };
-
-    auto req = loop().resource<details::ConnectReq>();
-    req->once<ErrorEvent>(listener);
-    req->once<ConnectEvent>(listener);
+    auto req = details::ConnectReq::acquire(loop());
+    req->completion(relay<ConnectEvent>());
     req->connect(&uv_tcp_connect, get(), &addr);
 }
 
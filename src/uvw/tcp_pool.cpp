@@ -0,0 +1,307 @@
+#ifdef UVW_AS_LIB
+#include "tcp_pool.h"
+#endif
+
+#include <algorithm>
+#include <iterator>
+
+#include "config.h"
+
+
+namespace uvw {
+
+
+UVW_INLINE void TCPConnectionPool::park(const Key &key, std::shared_ptr<TCPHandle> handle) {
+    auto listener = [pool = weak_from_this(), key](const auto &, TCPHandle &conn) {
+        // idle connections aren't supposed to receive anything
+        if(auto self = pool.lock(); self) {
+            self->discard(key, conn);
+        } else {
+            conn.close();
+        }
+    };
+
+    // only the listeners of the pool come and go, checkin takes care of the others
+    auto end = handle->on<EndEvent>(listener);
+    auto error = handle->on<ErrorEvent>(listener);
+    auto data = handle->on<DataEvent>(listener);
+
+    handle->stop();
+    handle->read();
+
+    buckets[key].push_back(Idle{std::move(handle), pLoop->now(), end, error, data});
+    ++info.idle;
+
+    if(!timer) {
+        timer = pLoop->resource<TimerHandle>();
+
+        if(!timer) {
+            return;
+        }
+
+        timer->on<TimerEvent>([pool = weak_from_this()](const auto &, auto &) {
+            if(auto self = pool.lock(); self) { self->reap(); }
+        });
+
+        // idle connections keep the loop alive on their own
+        timer->unreference();
+    }
+
+    if(!timer->active()) {
+        timer->start(timeout, timeout);
+    }
+}
+
+
+UVW_INLINE void TCPConnectionPool::discard(const Key &key, const TCPHandle &handle) noexcept {
+    if(auto it = buckets.find(key); it != buckets.end()) {
+        auto &bucket = it->second;
+        auto pred = [&handle](auto &&elem) { return elem.handle.get() == &handle; };
+
+        if(auto curr = std::find_if(bucket.begin(), bucket.end(), pred); curr != bucket.end()) {
+            unpark(*curr);
+            auto ptr = std::move(curr->handle);
+            bucket.erase(curr);
+            --info.idle;
+            ++info.discarded;
+            ptr->close();
+        }
+    }
+}
+
+
+UVW_INLINE void TCPConnectionPool::unpark(Idle &idle) noexcept {
+    idle.handle->erase(idle.end);
+    idle.handle->erase(idle.error);
+    idle.handle->erase(idle.data);
+}
+
+
+UVW_INLINE bool TCPConnectionPool::healthy(const TCPHandle &handle) const {
+    return !handle.closing() && handle.readable() && handle.writable() && (!probe || probe(handle));
+}
+
+
+UVW_INLINE void TCPConnectionPool::reap() {
+    const auto now = pLoop->now();
+
+    for(auto it = buckets.begin(); it != buckets.end();) {
+        auto &bucket = it->second;
+
+        // the least recently used connections are in front
+        while(!bucket.empty() && now - bucket.front().since >= timeout) {
+            unpark(bucket.front());
+            auto handle = std::move(bucket.front().handle);
+            bucket.pop_front();
+            --info.idle;
+            ++info.reaped;
+            handle->close();
+        }
+
+        it = bucket.empty() ? buckets.erase(it) : std::next(it);
+    }
+
+    // connections closed by the user rather than given back are forgotten
+    for(auto it = leased.begin(); it != leased.end();) {
+        it = it->second.first.expired() ? leased.erase(it) : std::next(it);
+    }
+
+    if(!info.idle) {
+        timer->stop();
+    }
+}
+
+
+UVW_INLINE TCPConnectionPool::TCPConnectionPool(ConstructorAccess, std::shared_ptr<Loop> ref)
+    : pLoop{std::move(ref)}, timer{}, buckets{}, leased{}, probe{},
+      max{DEFAULT_MAX_IDLE}, timeout{DEFAULT_TIMEOUT}, delay{DEFAULT_KEEP_ALIVE}, info{}
+{}
+
+
+UVW_INLINE std::shared_ptr<TCPConnectionPool> TCPConnectionPool::create(std::shared_ptr<Loop> loop) {
+    return std::make_shared<TCPConnectionPool>(ConstructorAccess{0}, std::move(loop));
+}
+
+
+UVW_INLINE TCPConnectionPool::~TCPConnectionPool() noexcept {
+    clear();
+
+    if(timer) {
+        timer->close();
+    }
+}
+
+
+template<typename I>
+UVW_INLINE void TCPConnectionPool::checkout(const std::string &ip, unsigned int port, Callback cb) {
+    Key key{ip, port};
+
+    if(auto it = buckets.find(key); it != buckets.end()) {
+        auto &bucket = it->second;
+
+        // the most recently used connections are the most likely to be alive
+        while(!bucket.empty()) {
+            unpark(bucket.back());
+            auto handle = std::move(bucket.back().handle);
+            bucket.pop_back();
+            --info.idle;
+
+            handle->stop();
+
+            if(healthy(*handle)) {
+                ++info.hits;
+                leased[handle.get()] = std::make_pair(handle, std::move(key));
+                cb(ErrorEvent{0}, std::move(handle));
+                return;
+            }
+
+            ++info.discarded;
+            handle->close();
+        }
+    }
+
+    ++info.misses;
+
+    auto handle = pLoop->resource<TCPHandle>();
+
+    if(!handle) {
+        cb(ErrorEvent{static_cast<int>(UV_ENOMEM)}, nullptr);
+        return;
+    }
+
+    auto pending = std::make_shared<Pending>(Pending{std::move(cb), {}, {}});
+
+    pending->error = handle->once<ErrorEvent>([pending](const ErrorEvent &event, TCPHandle &conn) {
+        conn.erase(pending->connect);
+        conn.close();
+        pending->callback(event, nullptr);
+    });
+
+    pending->connect = handle->once<ConnectEvent>([pool = weak_from_this(), key, pending, keep = delay](const ConnectEvent &, TCPHandle &conn) {
+        auto ref = conn.shared_from_this();
+        conn.erase(pending->error);
+
+        if(keep.count()) {
+            // libuv ignores the delay as long as there is no socket, that is until connected
+            conn.keepAlive(true, keep);
+        }
+
+        if(auto self = pool.lock(); self) {
+            self->leased[ref.get()] = std::make_pair(ref, key);
+        }
+
+        pending->callback(ErrorEvent{0}, std::move(ref));
+    });
+
+    handle->connect<I>(ip, port);
+}
+
+
+template<typename I>
+UVW_INLINE void TCPConnectionPool::checkout(Addr addr, Callback cb) {
+    checkout<I>(addr.ip, addr.port, std::move(cb));
+}
+
+
+UVW_INLINE bool TCPConnectionPool::checkin(std::shared_ptr<TCPHandle> handle) {
+    auto it = handle ? leased.find(handle.get()) : leased.end();
+
+    if(it == leased.end()) {
+        return false;
+    }
+
+    if(it->second.first.lock() != handle) {
+        // a connection closed by the user, the address was reused since then
+        leased.erase(it);
+        return false;
+    }
+
+    auto key = std::move(it->second.second);
+    leased.erase(it);
+
+    if(healthy(*handle) && (buckets.count(key) ? buckets[key].size() : 0u) < max) {
+        // the traffic of a lease doesn't concern the next borrower
+        handle->clear<DataEvent>();
+        handle->clear<EndEvent>();
+        handle->clear<WriteEvent>();
+        handle->clear<ShutdownEvent>();
+        handle->clear<PressureEvent>();
+        handle->clear<DrainEvent>();
+        handle->clear<ErrorEvent>();
+        park(key, std::move(handle));
+    } else {
+        handle->close();
+    }
+
+    return true;
+}
+
+
+UVW_INLINE void TCPConnectionPool::maxIdle(std::size_t count) noexcept {
+    max = count;
+}
+
+
+UVW_INLINE void TCPConnectionPool::idleTimeout(Time value) {
+    timeout = value;
+
+    if(timer && timer->active()) {
+        timer->start(timeout, timeout);
+    }
+}
+
+
+UVW_INLINE void TCPConnectionPool::keepAlive(TCPHandle::Time value) noexcept {
+    delay = value;
+}
+
+
+UVW_INLINE void TCPConnectionPool::healthCheck(Probe func) noexcept {
+    probe = std::move(func);
+}
+
+
+UVW_INLINE void TCPConnectionPool::clear() noexcept {
+    for(auto &&bucket: buckets) {
+        for(auto &&elem: bucket.second) {
+            unpark(elem);
+            elem.handle->close();
+        }
+    }
+
+    buckets.clear();
+    info.idle = 0u;
+
+    if(timer) {
+        timer->stop();
+    }
+}
+
+
+UVW_INLINE TCPConnectionPool::Stats TCPConnectionPool::stats() const noexcept {
+    return info;
+}
+
+
+UVW_INLINE double TCPConnectionPool::hitRate() const noexcept {
+    const auto total = info.hits + info.misses;
+    return total ? static_cast<double>(info.hits) / total : 0.;
+}
+
+
+UVW_INLINE Loop & TCPConnectionPool::loop() const noexcept {
+    return *pLoop;
+}
+
+
+// explicit instantiations
+#ifdef UVW_AS_LIB
+template void TCPConnectionPool::checkout<IPv4>(const std::string &, unsigned int, Callback);
+template void TCPConnectionPool::checkout<IPv6>(const std::string &, unsigned int, Callback);
+
+template void TCPConnectionPool::checkout<IPv4>(Addr, Callback);
+template void TCPConnectionPool::checkout<IPv6>(Addr, Callback);
+#endif // UVW_AS_LIB
+
+
+}
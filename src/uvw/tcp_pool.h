@@ -0,0 +1,244 @@
+#ifndef UVW_TCP_POOL_INCLUDE_H
+#define UVW_TCP_POOL_INCLUDE_H
+
+
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "emitter.h"
+#include "function.hpp"
+#include "loop.h"
+#include "tcp.h"
+#include "timer.h"
+#include "util.h"
+
+
+namespace uvw {
+
+
+/**
+ * @brief Pool of outbound TCP connections.
+ *
+ * The pool keeps the connections to the same upstreams open and hands them
+ * out again and again, rather than paying a handshake for each one of the
+ * requests. Connections are keyed by address (see Addr) and belong to the
+ * loop the pool was created for.
+ *
+ * Idle connections are kept reading, so that those closed by the peer or that
+ * receive unexpected data are discarded immediately. They're also checked
+ * once more before they're handed out. Connections idle for longer than the
+ * timeout are closed by a single timer shared by the whole pool.
+ *
+ * To create a `TCPConnectionPool` use the `create` function.
+ */
+class TCPConnectionPool final: public std::enable_shared_from_this<TCPConnectionPool> {
+    using Key = std::pair<std::string, unsigned int>;
+
+    struct Idle {
+        std::shared_ptr<TCPHandle> handle;
+        Loop::Time since;
+        TCPHandle::Connection<EndEvent> end;
+        TCPHandle::Connection<ErrorEvent> error;
+        TCPHandle::Connection<DataEvent> data;
+    };
+
+    struct Pending {
+        Function<void(const ErrorEvent &, std::shared_ptr<TCPHandle>)> callback;
+        TCPHandle::Connection<ErrorEvent> error;
+        TCPHandle::Connection<ConnectEvent> connect;
+    };
+
+    static constexpr std::size_t DEFAULT_MAX_IDLE = 8u;
+    static constexpr Loop::Time DEFAULT_TIMEOUT = Loop::Time{30000};
+    static constexpr TCPHandle::Time DEFAULT_KEEP_ALIVE = TCPHandle::Time{60};
+
+    struct ConstructorAccess { explicit ConstructorAccess(int) {} };
+
+    void park(const Key &key, std::shared_ptr<TCPHandle> handle);
+    void discard(const Key &key, const TCPHandle &handle) noexcept;
+    static void unpark(Idle &idle) noexcept;
+    bool healthy(const TCPHandle &handle) const;
+    void reap();
+
+public:
+    using Time = Loop::Time;
+    using Callback = Function<void(const ErrorEvent &, std::shared_ptr<TCPHandle>)>;
+    using Probe = Function<bool(const TCPHandle &)>;
+
+    /*! @brief Statistics about the pool. */
+    struct Stats {
+        std::size_t hits; /*!< Checkouts served by idle connections. */
+        std::size_t misses; /*!< Checkouts that required a new connection. */
+        std::size_t discarded; /*!< Idle connections found dead or unhealthy. */
+        std::size_t reaped; /*!< Idle connections closed on timeout. */
+        std::size_t idle; /*!< Connections currently idle. */
+    };
+
+    explicit TCPConnectionPool(ConstructorAccess, std::shared_ptr<Loop> ref);
+
+    /**
+     * @brief Creates a new pool of connections.
+     * @param loop A loop to which the connections belong.
+     * @return A pointer to the newly created pool.
+     */
+    static std::shared_ptr<TCPConnectionPool> create(std::shared_ptr<Loop> loop);
+
+    /*! @brief Closes all the idle connections. */
+    ~TCPConnectionPool() noexcept;
+
+    TCPConnectionPool(const TCPConnectionPool &) = delete;
+    TCPConnectionPool(TCPConnectionPool &&) = delete;
+
+    TCPConnectionPool & operator=(const TCPConnectionPool &) = delete;
+    TCPConnectionPool & operator=(TCPConnectionPool &&) = delete;
+
+    /**
+     * @brief Gets a connection to the given address.
+     *
+     * The most recently used idle connection is handed out if any, otherwise
+     * a new connection is established. In the first case the callback is
+     * invoked before this function returns, otherwise it's invoked once the
+     * connection succeeds or fails.<br/>
+     * In case of errors, the callback receives a non-empty ErrorEvent and an
+     * empty pointer.
+     *
+     * @param ip The address to which to connect.
+     * @param port The port to which to connect.
+     * @param cb The callback invoked with the connection.
+     */
+    template<typename I = IPv4>
+    void checkout(const std::string &ip, unsigned int port, Callback cb);
+
+    /**
+     * @brief Gets a connection to the given address.
+     *
+     * See the overload that takes an address and a port for further details.
+     *
+     * @param addr A valid instance of Addr.
+     * @param cb The callback invoked with the connection.
+     */
+    template<typename I = IPv4>
+    void checkout(Addr addr, Callback cb);
+
+    /**
+     * @brief Gives a connection back to the pool.
+     *
+     * The connection becomes idle, as long as it's still healthy and the pool
+     * doesn't exceed the maximum number of idle connections for its address.
+     * It's closed otherwise.<br/>
+     * Listeners for the traffic of the connection (DataEvent, EndEvent,
+     * WriteEvent, ShutdownEvent, PressureEvent, DrainEvent and ErrorEvent
+     * events) are removed when the connection becomes idle, so that the next
+     * borrower doesn't receive the events of the previous one. Listeners for
+     * any other event, CloseEvent included, are left untouched and stay for
+     * the whole lifetime of the connection.<br/>
+     * Connections that don't come from the pool are ignored. Connections
+     * closed by the user rather than given back are forgotten.
+     *
+     * @param handle A connection obtained through `checkout`.
+     * @return True if the connection has been taken back, false otherwise.
+     */
+    bool checkin(std::shared_ptr<TCPHandle> handle);
+
+    /**
+     * @brief Sets the maximum number of idle connections per address.
+     * @param count The maximum number of idle connections per address.
+     */
+    void maxIdle(std::size_t count) noexcept;
+
+    /**
+     * @brief Sets the idle timeout.
+     *
+     * Connections idle for longer than the timeout are closed. Because of the
+     * granularity of the timer, they can live up to twice the timeout.
+     *
+     * @param timeout The idle timeout, in milliseconds.
+     */
+    void idleTimeout(Time timeout);
+
+    /**
+     * @brief Sets the TCP keep-alive delay of the new connections.
+     * @param delay Initial delay in seconds, zero to disable keep-alive.
+     */
+    void keepAlive(TCPHandle::Time delay) noexcept;
+
+    /**
+     * @brief Sets an additional health check for idle connections.
+     *
+     * The check is performed before an idle connection is handed out, along
+     * with the built-in ones. Connections that fail it are closed.<br/>
+     * An empty function restores the default behavior.
+     *
+     * @param probe A function that returns true for healthy connections.
+     */
+    void healthCheck(Probe probe) noexcept;
+
+    /*! @brief Closes all the idle connections. */
+    void clear() noexcept;
+
+    /**
+     * @brief Gets the statistics of the pool.
+     * @return A snapshot of the statistics of the pool.
+     */
+    Stats stats() const noexcept;
+
+    /**
+     * @brief Gets the hit rate of the pool.
+     * @return The ratio of checkouts served by idle connections, between 0
+     * and 1.
+     */
+    double hitRate() const noexcept;
+
+    /**
+     * @brief Gets the loop from which the pool was originated.
+     * @return A reference to a loop instance.
+     */
+    Loop & loop() const noexcept;
+
+private:
+    std::shared_ptr<Loop> pLoop;
+    std::shared_ptr<TimerHandle> timer;
+    std::map<Key, std::deque<Idle>> buckets;
+    std::unordered_map<const TCPHandle *, std::pair<std::weak_ptr<TCPHandle>, Key>> leased;
+    Probe probe;
+    std::size_t max;
+    Time timeout;
+    TCPHandle::Time delay;
+    Stats info;
+};
+
+
+/**
+ * @cond TURN_OFF_DOXYGEN
+ * Internal details not to be documented.
+ */
+
+
+// (extern) explicit instantiations
+#ifdef UVW_AS_LIB
+extern template void TCPConnectionPool::checkout<IPv4>(const std::string &, unsigned int, Callback);
+extern template void TCPConnectionPool::checkout<IPv6>(const std::string &, unsigned int, Callback);
+
+extern template void TCPConnectionPool::checkout<IPv4>(Addr, Callback);
+extern template void TCPConnectionPool::checkout<IPv6>(Addr, Callback);
+#endif // UVW_AS_LIB
+
+
+/**
+ * Internal details not to be documented.
+ * @endcond
+ */
+
+
+}
+
+
+#ifndef UVW_AS_LIB
+#include "tcp_pool.cpp"
+#endif
+
+#endif // UVW_TCP_POOL_INCLUDE_H
@@ -8,6 +8,7 @@
 #include <type_traits>
 #include <utility>
 #include <uv.h>
+#include "function.hpp"
 #include "loop.h"
 #include "underlying_type.hpp"
 
@@ -43,11 +44,11 @@ class Barrier;
  * To create a `Thread` through a `Loop`, arguments follow:
  *
  * * A callback invoked to initialize thread execution. The type must be such
- * that it can be assigned to an `std::function<void(std::shared_ptr<void>)>`.
+ * that it can be assigned to a `Function<void(std::shared_ptr<void>)>`.
  * * An optional payload the type of which is `std::shared_ptr<void>`.
  */
 class Thread final: public UnderlyingType<Thread, uv_thread_t> {
-    using InternalTask = std::function<void(std::shared_ptr<void>)>;
+    using InternalTask = Function<void(std::shared_ptr<void>)>;
 
     static void createCallback(void *arg);
 
@@ -2,17 +2,53 @@
 #include "udp.h"
 #endif
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <limits>
+
+#ifdef __linux__
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#endif
+
 #include "config.h"
 
 
 namespace uvw {
 
 
-UVW_INLINE UDPDataEvent::UDPDataEvent(Addr sndr, std::unique_ptr<char[]> buf, std::size_t len, bool part) noexcept
-    : data{std::move(buf)}, length{len}, sender{std::move(sndr)}, partial{part}
+UVW_INLINE UDPDataEvent::UDPDataEvent(SockAddr sndr, std::unique_ptr<char[], BufferDeleter> buf, std::size_t len, bool part) noexcept
+    : data{std::move(buf)}, length{len}, sender{sndr}, partial{part}
 {}
 
 
+UVW_INLINE UDPBatchDataEvent::UDPBatchDataEvent(const UDPDatagram *first, std::size_t len) noexcept
+    : datagrams{first}, count{len}
+{}
+
+
+UVW_INLINE std::size_t UDPBatchDataEvent::size() const noexcept {
+    return count;
+}
+
+
+UVW_INLINE const UDPDatagram * UDPBatchDataEvent::begin() const noexcept {
+    return datagrams;
+}
+
+
+UVW_INLINE const UDPDatagram * UDPBatchDataEvent::end() const noexcept {
+    return datagrams + count;
+}
+
+
+UVW_INLINE const UDPDatagram & UDPBatchDataEvent::operator[](std::size_t pos) const noexcept {
+    return datagrams[pos];
+}
+
+
 UVW_INLINE details::SendReq::SendReq(ConstructorAccess ca, std::shared_ptr<Loop> loop, std::unique_ptr<char[], Deleter> dt, unsigned int len)
     : Request<SendReq, uv_udp_send_t>{ca, std::move(loop)},
       data{std::move(dt)},
@@ -20,11 +56,171 @@ UVW_INLINE details::SendReq::SendReq(ConstructorAccess ca, std::shared_ptr<Loop>
 {}
 
 
+UVW_INLINE void details::SendReq::assign(std::unique_ptr<char[], Deleter> dt, unsigned int len) noexcept {
+    data = std::move(dt);
+    buf = uv_buf_init(data.get(), len);
+}
+
+
+UVW_INLINE void details::SendReq::discard() noexcept {
+    data.reset();
+    buf = uv_buf_init(nullptr, 0u);
+}
+
+
 UVW_INLINE void details::SendReq::send(uv_udp_t *handle, const struct sockaddr *addr) {
     invoke(&uv_udp_send, get(), handle, &buf, 1, addr, &defaultCallback<SendEvent>);
 }
 
 
+UVW_INLINE void UDPHandle::recycle(char *ptr, void *payload) noexcept {
+    auto &udp = *static_cast<UDPHandle *>(payload);
+
+    if(udp.spare) {
+        details::deallocate(ptr);
+    } else {
+        udp.spare = std::unique_ptr<char[], BufferDeleter>{ptr, BufferDeleter::heap()};
+    }
+}
+
+
+UVW_INLINE void UDPHandle::sendBatchCallback(uv_udp_send_t *req, int status) {
+    auto *outgoing = static_cast<Outgoing *>(req->data);
+
+    if(status) {
+        ++outgoing->event.failed;
+        outgoing->event.error = outgoing->event.error ? outgoing->event.error : status;
+    } else {
+        ++outgoing->event.sent;
+    }
+
+    if(!--outgoing->pending) {
+        details::AllocatorPtr<Outgoing> ptr{outgoing};
+        ptr->handle->publish(ptr->event);
+    }
+}
+
+
+UVW_INLINE std::size_t UDPHandle::flush(std::vector<Datagram> &datagrams, SendBatchEvent &event) {
+    auto fail = [&event](int err) {
+        ++event.failed;
+        event.error = event.error ? event.error : err;
+    };
+
+    std::size_t pos{};
+
+#ifdef __linux__
+    uv_os_fd_t fd;
+
+    // the socket is created lazily, the first datagram takes care of it otherwise
+    if(0 == uv_fileno(get<uv_handle_t>(), &fd)) {
+        constexpr std::size_t width = 64u;
+        mmsghdr msgs[width];
+        iovec iov[width];
+
+        while(pos < datagrams.size()) {
+            const auto count = std::min(width, datagrams.size() - pos);
+
+            for(std::size_t next{}; next < count; ++next) {
+                auto &datagram = datagrams[pos + next];
+                iov[next].iov_base = datagram.second.data.get();
+                iov[next].iov_len = datagram.second.length;
+                msgs[next].msg_hdr = msghdr{};
+                msgs[next].msg_hdr.msg_name = &datagram.first;
+                msgs[next].msg_hdr.msg_namelen = static_cast<socklen_t>(datagram.first.size());
+                msgs[next].msg_hdr.msg_iov = &iov[next];
+                msgs[next].msg_hdr.msg_iovlen = 1;
+            }
+
+            const auto ret = sendmmsg(fd, msgs, static_cast<unsigned int>(count), MSG_DONTWAIT);
+
+            if(ret > 0) {
+                pos += static_cast<std::size_t>(ret);
+                event.sent += static_cast<std::size_t>(ret);
+            } else if(ret == 0) {
+                // nothing went out and errno isn't set, the rest is queued as usual
+                break;
+            } else if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            } else if(errno != EINTR) {
+                // the datagram in front is the faulty one, the others are retried
+                fail(-errno);
+                ++pos;
+            }
+        }
+
+        return pos;
+    }
+#endif
+
+    while(pos < datagrams.size()) {
+        auto &datagram = datagrams[pos];
+        uv_buf_t buf = uv_buf_init(datagram.second.data.get(), datagram.second.length);
+        const auto ret = uv_udp_try_send(get(), &buf, 1, &static_cast<const sockaddr &>(datagram.first));
+
+        if(ret == UV_EAGAIN) {
+            break;
+        } else if(ret < 0) {
+            fail(ret);
+        } else {
+            ++event.sent;
+        }
+
+        ++pos;
+    }
+
+    return pos;
+}
+
+
+UVW_INLINE void UDPHandle::sendBatch(std::vector<std::pair<SockAddr, Buffer>> datagrams) {
+    SendBatchEvent event{};
+    // datagrams go out immediately only if they can't overtake queued ones
+    const auto pos = sendQueueCount() ? 0u : flush(datagrams, event);
+
+    if(pos == datagrams.size()) {
+        publish(event);
+    } else {
+        datagrams.erase(datagrams.begin(), datagrams.begin() + pos);
+
+        const auto count = datagrams.size();
+        auto outgoing = details::allocateUnique<Outgoing>(Outgoing{shared_from_this(), std::move(datagrams), details::allocateUnique<uv_udp_send_t[]>(count), 0u, event});
+
+        for(std::size_t next{}; next < count; ++next) {
+            auto &datagram = outgoing->datagrams[next];
+            auto *req = &outgoing->reqs[next];
+            uv_buf_t buf = uv_buf_init(datagram.second.data.get(), datagram.second.length);
+            req->data = outgoing.get();
+
+            if(auto err = uv_udp_send(req, get(), &buf, 1, &static_cast<const sockaddr &>(datagram.first), &sendBatchCallback); err) {
+                ++outgoing->event.failed;
+                outgoing->event.error = outgoing->event.error ? outgoing->event.error : err;
+            } else {
+                ++outgoing->pending;
+            }
+        }
+
+        if(outgoing->pending) {
+            // released by the callback of the last request
+            outgoing.release();
+        } else {
+            publish(outgoing->event);
+        }
+    }
+}
+
+
+UVW_INLINE std::unique_ptr<char[], BufferDeleter> UDPHandle::reuse(std::size_t size) {
+    if(size != capacity) {
+        spare.reset();
+        capacity = size;
+    }
+
+    auto *ptr = spare ? spare.release() : static_cast<char *>(details::allocate(size));
+    return std::unique_ptr<char[], BufferDeleter>{ptr, BufferDeleter{&recycle, this}};
+}
+
+
 UVW_INLINE UDPHandle::UDPHandle(ConstructorAccess ca, std::shared_ptr<Loop> ref, unsigned int f)
     : Handle{ca, std::move(ref)}, tag{FLAGS}, flags{f}
 {}
@@ -127,24 +323,38 @@ UVW_INLINE bool UDPHandle::ttl(int val) {
 }
 
 
-UVW_INLINE void UDPHandle::send(const sockaddr &addr, std::unique_ptr<char[]> data, unsigned int len) {
-    auto req = loop().resource<details::SendReq>(
-            std::unique_ptr<char[], details::SendReq::Deleter>{data.release(), [](char *ptr) {
-                delete[] ptr;
-            }}, len);
+UVW_INLINE bool UDPHandle::gso([[maybe_unused]] unsigned int size) {
+#if defined(__linux__) && defined(UDP_SEGMENT)
+    uv_os_fd_t fd;
+    int value = static_cast<int>(size);
+    return (0 == uv_fileno(get<uv_handle_t>(), &fd)) && (0 == setsockopt(fd, SOL_UDP, UDP_SEGMENT, &value, sizeof(value)));
+#else
+    return false;
+#endif
+}
+
+
+UVW_INLINE bool UDPHandle::gro([[maybe_unused]] bool enable) {
+#if defined(__linux__) && defined(UDP_GRO)
+    uv_os_fd_t fd;
+    int value = enable;
+    return (0 == uv_fileno(get<uv_handle_t>(), &fd)) && (0 == setsockopt(fd, SOL_UDP, UDP_GRO, &value, sizeof(value)));
+#else
+    return false;
+#endif
+}
 
-    auto listener = [ptr = shared_from_this()](const auto &event, const auto &) {
-        ptr->publish(event);
-    };
 
-    req->once<ErrorEvent>(listener);
-    req->once<SendEvent>(listener);
+UVW_INLINE void UDPHandle::send(const sockaddr &addr, std::unique_ptr<char[], BufferDeleter> data, unsigned int len) {
+    auto req = details::SendReq::acquire(loop(), std::move(data), len);
+
+    req->completion(relay<SendEvent>());
     req->send(get(), &addr);
 }
 
 
 template<typename I>
-UVW_INLINE void UDPHandle::send(const std::string &ip, unsigned int port, std::unique_ptr<char[]> data, unsigned int len) {
+UVW_INLINE void UDPHandle::send(const std::string &ip, unsigned int port, std::unique_ptr<char[], BufferDeleter> data, unsigned int len) {
     typename details::IpTraits<I>::Type addr;
     details::IpTraits<I>::addrFunc(ip.data(), port, &addr);
     send(reinterpret_cast<const sockaddr &>(addr), std::move(data), len);
@@ -152,22 +362,16 @@ UVW_INLINE void UDPHandle::send(const std::string &ip, unsigned int port, std::u
 
 
 template<typename I>
-UVW_INLINE void UDPHandle::send(Addr addr, std::unique_ptr<char[]> data, unsigned int len) {
+UVW_INLINE void UDPHandle::send(Addr addr, std::unique_ptr<char[], BufferDeleter> data, unsigned int len) {
     send<I>(std::move(addr.ip), addr.port, std::move(data), len);
 }
 
 
 UVW_INLINE void UDPHandle::send(const sockaddr &addr, char *data, unsigned int len) {
-    auto req = loop().resource<details::SendReq>(
-            std::unique_ptr<char[], details::SendReq::Deleter>{data, [](char *) {
-            }}, len);
-
-    auto listener = [ptr = shared_from_this()](const auto &event, const auto &) {
-        ptr->publish(event);
-    };
+    auto req = details::SendReq::acquire(loop(),
+            std::unique_ptr<char[], details::SendReq::Deleter>{data, BufferDeleter{[](char *, void *) noexcept {}, nullptr}}, len);
 
-    req->once<ErrorEvent>(listener);
-    req->once<SendEvent>(listener);
+    req->completion(relay<SendEvent>());
     req->send(get(), &addr);
 }
 
@@ -187,7 +391,7 @@ UVW_INLINE void UDPHandle::send(Addr addr, char *data, unsigned int len) {
 
 
 template<typename I>
-UVW_INLINE int UDPHandle::trySend(const sockaddr &addr, std::unique_ptr<char[]> data, unsigned int len) {
+UVW_INLINE int UDPHandle::trySend(const sockaddr &addr, std::unique_ptr<char[], BufferDeleter> data, unsigned int len) {
     uv_buf_t bufs[] = { uv_buf_init(data.get(), len) };
     auto bw = uv_udp_try_send(get(), bufs, 1, &addr);
 
@@ -201,7 +405,7 @@ UVW_INLINE int UDPHandle::trySend(const sockaddr &addr, std::unique_ptr<char[]>
 
 
 template<typename I>
-UVW_INLINE int UDPHandle::trySend(const std::string &ip, unsigned int port, std::unique_ptr<char[]> data, unsigned int len) {
+UVW_INLINE int UDPHandle::trySend(const std::string &ip, unsigned int port, std::unique_ptr<char[], BufferDeleter> data, unsigned int len) {
     typename details::IpTraits<I>::Type addr;
     details::IpTraits<I>::addrFunc(ip.data(), port, &addr);
     return trySend(reinterpret_cast<const sockaddr &>(addr), std::move(data), len);
@@ -209,7 +413,7 @@ UVW_INLINE int UDPHandle::trySend(const std::string &ip, unsigned int port, std:
 
 
 template<typename I>
-UVW_INLINE int UDPHandle::trySend(Addr addr, std::unique_ptr<char[]> data, unsigned int len) {
+UVW_INLINE int UDPHandle::trySend(Addr addr, std::unique_ptr<char[], BufferDeleter> data, unsigned int len) {
     return trySend<I>(std::move(addr.ip), addr.port, std::move(data), len);
 }
 
@@ -242,9 +446,91 @@ UVW_INLINE int UDPHandle::trySend(Addr addr, char *data, unsigned int len) {
 }
 
 
+UVW_INLINE int UDPHandle::trySend([[maybe_unused]] const sockaddr &addr, [[maybe_unused]] char *data, [[maybe_unused]] unsigned int len, [[maybe_unused]] unsigned int segment) {
+    int bw = UV_ENOTSUP;
+
+#if defined(__linux__) && defined(UDP_SEGMENT)
+    uv_os_fd_t fd;
+    // the size of the segments goes out as a 16-bit value, it mustn't be truncated
+    bw = (segment > std::numeric_limits<std::uint16_t>::max()) ? UV_EINVAL : uv_fileno(get<uv_handle_t>(), &fd);
+
+    if(0 == bw) {
+        char control[CMSG_SPACE(sizeof(std::uint16_t))]{};
+        iovec iov{data, len};
+        msghdr msg{};
+        msg.msg_name = const_cast<sockaddr *>(&addr);
+        msg.msg_namelen = addr.sa_family == AF_INET6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        // the size of the segments goes along with the data, the socket option is left untouched
+        auto *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+        *reinterpret_cast<std::uint16_t *>(CMSG_DATA(cmsg)) = static_cast<std::uint16_t>(segment);
+
+        do {
+            bw = static_cast<int>(sendmsg(fd, &msg, MSG_DONTWAIT));
+        } while(bw < 0 && errno == EINTR);
+
+        bw = bw < 0 ? -errno : bw;
+    }
+#endif
+
+    if(bw < 0) {
+        publish(ErrorEvent{bw});
+        bw = 0;
+    }
+
+    return bw;
+}
+
+
+template<typename I>
+UVW_INLINE int UDPHandle::trySend(const std::string &ip, unsigned int port, char *data, unsigned int len, unsigned int segment) {
+    typename details::IpTraits<I>::Type addr;
+    details::IpTraits<I>::addrFunc(ip.data(), port, &addr);
+    return trySend(reinterpret_cast<const sockaddr &>(addr), data, len, segment);
+}
+
+
+template<typename I>
+UVW_INLINE int UDPHandle::trySend(Addr addr, char *data, unsigned int len, unsigned int segment) {
+    return trySend<I>(std::move(addr.ip), addr.port, data, len, segment);
+}
+
+
+template<typename I>
+UVW_INLINE void UDPHandle::sendBatch(std::vector<std::pair<Addr, Buffer>> datagrams) {
+    std::vector<Datagram> batch{};
+    batch.reserve(datagrams.size());
+
+    for(auto &&datagram: datagrams) {
+        typename details::IpTraits<I>::Type addr;
+        details::IpTraits<I>::addrFunc(datagram.first.ip.data(), datagram.first.port, &addr);
+        batch.emplace_back(SockAddr{reinterpret_cast<const sockaddr &>(addr)}, std::move(datagram.second));
+    }
+
+    sendBatch(std::move(batch));
+}
+
+
 template<typename I>
 UVW_INLINE void UDPHandle::recv() {
-    invoke(&uv_udp_recv_start, get(), &allocCallback, &recvCallback<I>);
+    if(uv_udp_using_recvmmsg(get())) {
+        batch.reserve(BATCH_SIZE);
+        invoke(&uv_udp_recv_start, get(), &batchAllocCallback, &recvCallback<I>);
+    } else {
+        invoke(&uv_udp_recv_start, get(), &allocCallback, &recvCallback<I>);
+    }
+}
+
+
+UVW_INLINE void UDPHandle::allocator(BufferAllocator alloc) noexcept {
+    Handle::allocator(std::move(alloc));
 }
 
 
@@ -289,11 +575,11 @@ template bool UDPHandle::multicastMembership<IPv6>(const std::string &, const st
 template bool UDPHandle::multicastInterface<IPv4>(const std::string &);
 template bool UDPHandle::multicastInterface<IPv6>(const std::string &);
 
-template void UDPHandle::send<IPv4>(const std::string &, unsigned int, std::unique_ptr<char[]>, unsigned int);
-template void UDPHandle::send<IPv6>(const std::string &, unsigned int, std::unique_ptr<char[]>, unsigned int);
+template void UDPHandle::send<IPv4>(const std::string &, unsigned int, std::unique_ptr<char[], BufferDeleter>, unsigned int);
+template void UDPHandle::send<IPv6>(const std::string &, unsigned int, std::unique_ptr<char[], BufferDeleter>, unsigned int);
 
-template void UDPHandle::send<IPv4>(Addr, std::unique_ptr<char[]>, unsigned int);
-template void UDPHandle::send<IPv6>(Addr, std::unique_ptr<char[]>, unsigned int);
+template void UDPHandle::send<IPv4>(Addr, std::unique_ptr<char[], BufferDeleter>, unsigned int);
+template void UDPHandle::send<IPv6>(Addr, std::unique_ptr<char[], BufferDeleter>, unsigned int);
 
 template void UDPHandle::send<IPv4>(const std::string &, unsigned int, char *, unsigned int);
 template void UDPHandle::send<IPv6>(const std::string &, unsigned int, char *, unsigned int);
@@ -301,14 +587,14 @@ template void UDPHandle::send<IPv6>(const std::string &, unsigned int, char *, u
 template void UDPHandle::send<IPv4>(Addr, char *, unsigned int);
 template void UDPHandle::send<IPv6>(Addr, char *, unsigned int);
 
-template int UDPHandle::trySend<IPv4>(const sockaddr &, std::unique_ptr<char[]>, unsigned int);
-template int UDPHandle::trySend<IPv6>(const sockaddr &, std::unique_ptr<char[]>, unsigned int);
+template int UDPHandle::trySend<IPv4>(const sockaddr &, std::unique_ptr<char[], BufferDeleter>, unsigned int);
+template int UDPHandle::trySend<IPv6>(const sockaddr &, std::unique_ptr<char[], BufferDeleter>, unsigned int);
 
-template int UDPHandle::trySend<IPv4>(const std::string &, unsigned int, std::unique_ptr<char[]>, unsigned int);
-template int UDPHandle::trySend<IPv6>(const std::string &, unsigned int, std::unique_ptr<char[]>, unsigned int);
+template int UDPHandle::trySend<IPv4>(const std::string &, unsigned int, std::unique_ptr<char[], BufferDeleter>, unsigned int);
+template int UDPHandle::trySend<IPv6>(const std::string &, unsigned int, std::unique_ptr<char[], BufferDeleter>, unsigned int);
 
-template int UDPHandle::trySend<IPv4>(Addr, std::unique_ptr<char[]>, unsigned int);
-template int UDPHandle::trySend<IPv6>(Addr, std::unique_ptr<char[]>, unsigned int);
+template int UDPHandle::trySend<IPv4>(Addr, std::unique_ptr<char[], BufferDeleter>, unsigned int);
+template int UDPHandle::trySend<IPv6>(Addr, std::unique_ptr<char[], BufferDeleter>, unsigned int);
 
 template int UDPHandle::trySend<IPv4>(const sockaddr &, char *, unsigned int);
 template int UDPHandle::trySend<IPv6>(const sockaddr &, char *, unsigned int);
@@ -319,6 +605,15 @@ template int UDPHandle::trySend<IPv6>(const std::string &, unsigned int, char *,
 template int UDPHandle::trySend<IPv4>(Addr, char *, unsigned int);
 template int UDPHandle::trySend<IPv6>(Addr, char *, unsigned int);
 
+template int UDPHandle::trySend<IPv4>(const std::string &, unsigned int, char *, unsigned int, unsigned int);
+template int UDPHandle::trySend<IPv6>(const std::string &, unsigned int, char *, unsigned int, unsigned int);
+
+template int UDPHandle::trySend<IPv4>(Addr, char *, unsigned int, unsigned int);
+template int UDPHandle::trySend<IPv6>(Addr, char *, unsigned int, unsigned int);
+
+template void UDPHandle::sendBatch<IPv4>(std::vector<std::pair<Addr, Buffer>>);
+template void UDPHandle::sendBatch<IPv6>(std::vector<std::pair<Addr, Buffer>>);
+
 template void UDPHandle::recv<IPv4>();
 template void UDPHandle::recv<IPv6>();
 #endif // UVW_AS_LIB
@@ -7,6 +7,8 @@
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <uv.h>
 #include "request.hpp"
 #include "handle.hpp"
@@ -24,21 +26,85 @@ namespace uvw {
 struct SendEvent {};
 
 
+/**
+ * @brief SendBatchEvent event.
+ *
+ * It will be emitted by UDPHandle according with its functionalities.
+ */
+struct SendBatchEvent {
+    std::size_t sent; /*!< The number of datagrams sent. */
+    std::size_t failed; /*!< The number of datagrams that couldn't be sent. */
+    int error; /*!< The first error that occurred, zero if none. */
+};
+
+
 /**
  * @brief UDPDataEvent event.
  *
  * It will be emitted by UDPHandle according with its functionalities.
  */
 struct UDPDataEvent {
-    explicit UDPDataEvent(Addr sndr, std::unique_ptr<char[]> buf, std::size_t len, bool part) noexcept;
+    explicit UDPDataEvent(SockAddr sndr, std::unique_ptr<char[], BufferDeleter> buf, std::size_t len, bool part) noexcept;
 
-    std::unique_ptr<char[]> data; /*!< A bunch of data read on the stream. */
+    std::unique_ptr<char[], BufferDeleter> data; /*!< A bunch of data read on the stream. */
     std::size_t length;  /*!< The amount of data read on the stream. */
-    Addr sender; /*!< A valid instance of Addr. */
+    SockAddr sender; /*!< The address of the sender. */
     bool partial; /*!< True if the message was truncated, false otherwise. */
 };
 
 
+/**
+ * @brief Datagram received as part of a batch.
+ *
+ * The data are a view of the buffer of the batch, they aren't valid anymore
+ * once the UDPBatchDataEvent event has been published.
+ */
+struct UDPDatagram {
+    SockAddr sender; /*!< The address of the sender. */
+    std::string_view data; /*!< A view of the data of the datagram. */
+    bool partial; /*!< True if the message was truncated, false otherwise. */
+};
+
+
+/**
+ * @brief UDPBatchDataEvent event.
+ *
+ * It will be emitted by UDPHandle according with its functionalities.
+ */
+struct UDPBatchDataEvent {
+    explicit UDPBatchDataEvent(const UDPDatagram *first, std::size_t count) noexcept;
+
+    /**
+     * @brief Gets the number of datagrams of the batch.
+     * @return The number of datagrams of the batch.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Returns an iterator to the first datagram of the batch.
+     * @return An iterator to the first datagram of the batch.
+     */
+    const UDPDatagram * begin() const noexcept;
+
+    /**
+     * @brief Returns an iterator past the last datagram of the batch.
+     * @return An iterator past the last datagram of the batch.
+     */
+    const UDPDatagram * end() const noexcept;
+
+    /**
+     * @brief Gets a datagram of the batch.
+     * @param pos The index of the datagram, less than `size()`.
+     * @return A reference to the datagram.
+     */
+    const UDPDatagram & operator[](std::size_t pos) const noexcept;
+
+private:
+    const UDPDatagram *datagrams;
+    std::size_t count;
+};
+
+
 namespace details {
 
 
@@ -60,10 +126,18 @@ enum class UVMembership: std::underlying_type_t<uv_membership> {
 
 class SendReq final: public Request<SendReq, uv_udp_send_t> {
 public:
-    using Deleter = void(*)(char *);
+    using Deleter = BufferDeleter;
+
+    static constexpr bool RECYCLABLE = true;
+
+    using Request::acquire;
+    using Request::completion;
 
     SendReq(ConstructorAccess ca, std::shared_ptr<Loop> loop, std::unique_ptr<char[], Deleter> dt, unsigned int len);
 
+    void assign(std::unique_ptr<char[], Deleter> dt, unsigned int len) noexcept;
+    void discard() noexcept;
+
     void send(uv_udp_t *handle, const struct sockaddr* addr);
 
 private:
@@ -92,28 +166,72 @@ private:
  * for further details.
  */
 class UDPHandle final: public Handle<UDPHandle, uv_udp_t> {
+    static constexpr std::size_t BATCH_SIZE = 20u;
+
+    using Datagram = std::pair<SockAddr, Buffer>;
+
+    struct Outgoing {
+        std::shared_ptr<UDPHandle> handle;
+        // taken from the user as is
+        std::vector<Datagram> datagrams;
+        details::AllocatorPtr<uv_udp_send_t[]> reqs;
+        std::size_t pending;
+        SendBatchEvent event;
+    };
+
     template<typename I>
     static void recvCallback(uv_udp_t *handle, ssize_t nread, const uv_buf_t *buf, const sockaddr *addr, unsigned flags) {
-        const typename details::IpTraits<I>::Type *aptr = reinterpret_cast<const typename details::IpTraits<I>::Type *>(addr);
+        // addresses are formatted on demand, only the raw data are copied here
+        const auto sender = addr ? SockAddr{*addr} : SockAddr{};
 
         UDPHandle &udp = *(static_cast<UDPHandle*>(handle->data));
-        // data will be destroyed no matter of what the value of nread is
-        std::unique_ptr<char[]> data{buf->base};
 
-        if(nread > 0) {
+        if(flags & UV_UDP_MMSG_CHUNK) {
+            // chunks are views of the buffer of the batch, it's released separately
+            if(nread > 0 || addr != nullptr) {
+                const auto view = std::string_view{buf->base, static_cast<std::size_t>(nread)};
+                udp.batch.push_back(UDPDatagram{sender, view, !(0 == (flags & UV_UDP_PARTIAL))});
+            }
+
+            return;
+        }
+
+        // data will be destroyed no matter of what the value of nread is
+        auto data = udp.acquire(buf->base);
+
+        if(flags & UV_UDP_MMSG_FREE) {
+            // the whole batch has been received, the buffer goes away right after
+            if(!udp.batch.empty()) {
+                udp.publish(UDPBatchDataEvent{udp.batch.data(), udp.batch.size()});
+                udp.batch.clear();
+            }
+        } else if(nread > 0) {
             // data available (can be truncated)
-            udp.publish(UDPDataEvent{details::address<I>(aptr), std::move(data), static_cast<std::size_t>(nread), !(0 == (flags & UV_UDP_PARTIAL))});
+            udp.publish(UDPDataEvent{sender, std::move(data), static_cast<std::size_t>(nread), !(0 == (flags & UV_UDP_PARTIAL))});
         } else if(nread == 0 && addr == nullptr) {
             // no more data to be read, doing nothing is fine
         } else if(nread == 0 && addr != nullptr) {
             // empty udp packet
-            udp.publish(UDPDataEvent{details::address<I>(aptr), std::move(data), static_cast<std::size_t>(nread), false});
+            udp.publish(UDPDataEvent{sender, std::move(data), static_cast<std::size_t>(nread), false});
         } else {
             // transmission error
             udp.publish(ErrorEvent(nread));
         }
     }
 
+    static void batchAllocCallback(uv_handle_t *handle, std::size_t suggested, uv_buf_t *buf) {
+        UDPHandle &udp = *(static_cast<UDPHandle*>(handle->data));
+        // libuv reserves a slot of the suggested size for each datagram of a batch
+        udp.lend(suggested * BATCH_SIZE, buf, [&udp](std::size_t size) { return udp.reuse(size); });
+    }
+
+    static void recycle(char *ptr, void *payload) noexcept;
+    static void sendBatchCallback(uv_udp_send_t *req, int status);
+
+    std::size_t flush(std::vector<Datagram> &datagrams, SendBatchEvent &event);
+
+    std::unique_ptr<char[], BufferDeleter> reuse(std::size_t size);
+
 public:
     using Membership = details::UVMembership;
     using Bind = details::UVUDPFlags;
@@ -334,6 +452,40 @@ public:
      */
     bool ttl(int val);
 
+    /**
+     * @brief Sets the size of the segments of outgoing datagrams.
+     *
+     * Generic segmentation offload (`UDP_SEGMENT`): the kernel splits the
+     * data of each send into datagrams of the given size, the last one can be
+     * shorter. It requires the socket to exist, that is the handle must be
+     * bound or initialized with a family.<br/>
+     * Available only on Linux, as long as the system headers support it.
+     *
+     * @param size The size of the segments, zero to disable segmentation.
+     * @return True in case of success, false otherwise.
+     */
+    bool gso(unsigned int size);
+
+    /**
+     * @brief Enables or disables the coalescing of incoming datagrams.
+     *
+     * Generic receive offload (`UDP_GRO`): the kernel coalesces datagrams of
+     * the same flow into larger packets.<br/>
+     * The kernel reports the size of the segments along with each packet,
+     * but libuv doesn't hand it out. Therefore, coalesced packets are
+     * delivered as they are, the same as any other datagram, and the
+     * boundaries of the original datagrams are lost. Enable it only if the
+     * application protocol can split the data on its own, for example
+     * because the segment size is known in advance.<br/>
+     * It requires the socket to exist, that is the handle must be bound or
+     * initialized with a family.<br/>
+     * Available only on Linux, as long as the system headers support it.
+     *
+     * @param enable True to enable coalescing, false otherwise.
+     * @return True in case of success, false otherwise.
+     */
+    bool gro(bool enable);
+
     /**
      * @brief Sends data over the UDP socket.
      *
@@ -341,8 +493,8 @@ public:
      * will be bound to `0.0.0.0` (the _all interfaces_ IPv4 address) and a
      * random port number.
      *
-     * The handle takes the ownership of the data and it is in charge of delete
-     * them.
+     * The handle takes the ownership of the data and releases them according
+     * to their deleter.
      *
      * A SendEvent event will be emitted when the data have been sent.<br/>
      * An ErrorEvent event will be emitted in case of errors.
@@ -351,7 +503,7 @@ public:
      * @param data The data to be sent.
      * @param len The lenght of the submitted data.
      */
-    void send(const sockaddr &addr, std::unique_ptr<char[]> data, unsigned int len);
+    void send(const sockaddr &addr, std::unique_ptr<char[], BufferDeleter> data, unsigned int len);
 
     /**
      * @brief Sends data over the UDP socket.
@@ -360,8 +512,8 @@ public:
      * will be bound to `0.0.0.0` (the _all interfaces_ IPv4 address) and a
      * random port number.
      *
-     * The handle takes the ownership of the data and it is in charge of delete
-     * them.
+     * The handle takes the ownership of the data and releases them according
+     * to their deleter.
      *
      * A SendEvent event will be emitted when the data have been sent.<br/>
      * An ErrorEvent event will be emitted in case of errors.
@@ -372,7 +524,7 @@ public:
      * @param len The lenght of the submitted data.
      */
     template<typename I = IPv4>
-    void send(const std::string &ip, unsigned int port, std::unique_ptr<char[]> data, unsigned int len);
+    void send(const std::string &ip, unsigned int port, std::unique_ptr<char[], BufferDeleter> data, unsigned int len);
 
     /**
      * @brief Sends data over the UDP socket.
@@ -381,8 +533,8 @@ public:
      * will be bound to `0.0.0.0` (the _all interfaces_ IPv4 address) and a
      * random port number.
      *
-     * The handle takes the ownership of the data and it is in charge of delete
-     * them.
+     * The handle takes the ownership of the data and releases them according
+     * to their deleter.
      *
      * A SendEvent event will be emitted when the data have been sent.<br/>
      * An ErrorEvent event will be emitted in case of errors.
@@ -392,7 +544,7 @@ public:
      * @param len The lenght of the submitted data.
      */
     template<typename I = IPv4>
-    void send(Addr addr, std::unique_ptr<char[]> data, unsigned int len);
+    void send(Addr addr, std::unique_ptr<char[], BufferDeleter> data, unsigned int len);
 
     /**
      * @brief Sends data over the UDP socket.
@@ -466,7 +618,7 @@ public:
      * @return Number of bytes written.
      */
     template<typename I = IPv4>
-    int trySend(const sockaddr &addr, std::unique_ptr<char[]> data, unsigned int len);
+    int trySend(const sockaddr &addr, std::unique_ptr<char[], BufferDeleter> data, unsigned int len);
 
     /**
      * @brief Sends data over the UDP socket.
@@ -481,7 +633,7 @@ public:
      * @return Number of bytes written.
      */
     template<typename I = IPv4>
-    int trySend(const std::string &ip, unsigned int port, std::unique_ptr<char[]> data, unsigned int len);
+    int trySend(const std::string &ip, unsigned int port, std::unique_ptr<char[], BufferDeleter> data, unsigned int len);
 
     /**
      * @brief Sends data over the UDP socket.
@@ -495,7 +647,7 @@ public:
      * @return Number of bytes written.
      */
     template<typename I = IPv4>
-    int trySend(Addr addr, std::unique_ptr<char[]> data, unsigned int len);
+    int trySend(Addr addr, std::unique_ptr<char[], BufferDeleter> data, unsigned int len);
 
     /**
      * @brief Sends data over the UDP socket.
@@ -540,6 +692,88 @@ public:
     template<typename I = IPv4>
     int trySend(Addr addr, char *data, unsigned int len);
 
+    /**
+     * @brief Sends data over the UDP socket as a burst of datagrams.
+     *
+     * Same as `trySend()`, but the kernel splits the data into datagrams of
+     * the given size, the last one can be shorter (see `gso()`). The socket
+     * must be bound. Segments larger than 65535 bytes are rejected with
+     * `UV_EINVAL`.<br/>
+     * Available only on Linux, as long as the system headers support it.
+     *
+     * @param addr Initialized `sockaddr_in` or `sockaddr_in6` data structure.
+     * @param data The data to be sent.
+     * @param len The lenght of the submitted data.
+     * @param segment The size of the datagrams.
+     * @return Number of bytes written.
+     */
+    int trySend(const sockaddr &addr, char *data, unsigned int len, unsigned int segment);
+
+    /**
+     * @brief Sends data over the UDP socket as a burst of datagrams.
+     *
+     * Same as `trySend()`, but the kernel splits the data into datagrams of
+     * the given size, the last one can be shorter (see `gso()`). The socket
+     * must be bound. Segments larger than 65535 bytes are rejected with
+     * `UV_EINVAL`.<br/>
+     * Available only on Linux, as long as the system headers support it.
+     *
+     * @param ip The address to which to send data.
+     * @param port The port to which to send data.
+     * @param data The data to be sent.
+     * @param len The lenght of the submitted data.
+     * @param segment The size of the datagrams.
+     * @return Number of bytes written.
+     */
+    template<typename I = IPv4>
+    int trySend(const std::string &ip, unsigned int port, char *data, unsigned int len, unsigned int segment);
+
+    /**
+     * @brief Sends data over the UDP socket as a burst of datagrams.
+     *
+     * Same as `trySend()`, but the kernel splits the data into datagrams of
+     * the given size, the last one can be shorter (see `gso()`). The socket
+     * must be bound. Segments larger than 65535 bytes are rejected with
+     * `UV_EINVAL`.<br/>
+     * Available only on Linux, as long as the system headers support it.
+     *
+     * @param addr A valid instance of Addr.
+     * @param data The data to be sent.
+     * @param len The lenght of the submitted data.
+     * @param segment The size of the datagrams.
+     * @return Number of bytes written.
+     */
+    template<typename I = IPv4>
+    int trySend(Addr addr, char *data, unsigned int len, unsigned int segment);
+
+    /**
+     * @brief Sends a batch of datagrams.
+     *
+     * As many datagrams as possible are sent immediately, with a single
+     * `sendmmsg` call on Linux or one `uv_udp_try_send` call each elsewhere,
+     * as long as no other send requests are queued. The remaining ones are
+     * queued, all of them with a single allocation.<br/>
+     * Buffers that own their data are released once sent, the others must
+     * stay valid until the batch is complete.
+     *
+     * A single SendBatchEvent event will be emitted once all the datagrams
+     * have been either sent or discarded because of errors. It's emitted
+     * before this function returns if the whole batch is sent immediately.
+     *
+     * @param datagrams Pairs of destinations and data to send.
+     */
+    template<typename I = IPv4>
+    void sendBatch(std::vector<std::pair<Addr, Buffer>> datagrams);
+
+    /**
+     * @brief Sends a batch of datagrams.
+     *
+     * See the overload that takes instances of Addr for further details.
+     *
+     * @param datagrams Pairs of destinations and data to send.
+     */
+    void sendBatch(std::vector<std::pair<SockAddr, Buffer>> datagrams);
+
     /**
      * @brief Prepares for receiving data.
      *
@@ -549,10 +783,28 @@ public:
      *
      * An UDPDataEvent event will be emitted when the handle receives data.<br/>
      * An ErrorEvent event will be emitted in case of errors.
+     *
+     * Handles created with the `UV_UDP_RECVMMSG` flag receive up to 20
+     * datagrams per system call where `recvmmsg` is available. In this case,
+     * an UDPBatchDataEvent event is emitted for each batch rather than an
+     * UDPDataEvent event for each datagram. Batches are received into a
+     * single buffer that the handle recycles, unless an allocator is set.
      */
     template<typename I = IPv4>
     void recv();
 
+    /**
+     * @brief Sets the allocator used to get the buffers to receive into.
+     *
+     * By default, buffers are drawn from the pool of the loop. A custom
+     * allocator can provide smaller buffers or buffers that belong to a
+     * protocol specific structure, the deleter of which is propagated to
+     * `UDPDataEvent::data`. An empty allocator restores the default behavior.
+     *
+     * @param alloc A buffer allocator, possibly empty.
+     */
+    void allocator(BufferAllocator alloc) noexcept;
+
     /**
      * @brief Stops listening for incoming datagrams.
      */
@@ -576,6 +828,9 @@ public:
 private:
     enum { DEFAULT, FLAGS } tag{DEFAULT};
     unsigned int flags{};
+    std::vector<UDPDatagram, details::AllocatorAdapter<UDPDatagram>> batch{};
+    std::unique_ptr<char[], BufferDeleter> spare{};
+    std::size_t capacity{};
 };
 
 
@@ -611,11 +866,11 @@ extern template bool UDPHandle::multicastMembership<IPv6>(const std::string &, c
 extern template bool UDPHandle::multicastInterface<IPv4>(const std::string &);
 extern template bool UDPHandle::multicastInterface<IPv6>(const std::string &);
 
-extern template void UDPHandle::send<IPv4>(const std::string &, unsigned int, std::unique_ptr<char[]>, unsigned int);
-extern template void UDPHandle::send<IPv6>(const std::string &, unsigned int, std::unique_ptr<char[]>, unsigned int);
+extern template void UDPHandle::send<IPv4>(const std::string &, unsigned int, std::unique_ptr<char[], BufferDeleter>, unsigned int);
+extern template void UDPHandle::send<IPv6>(const std::string &, unsigned int, std::unique_ptr<char[], BufferDeleter>, unsigned int);
 
-extern template void UDPHandle::send<IPv4>(Addr, std::unique_ptr<char[]>, unsigned int);
-extern template void UDPHandle::send<IPv6>(Addr, std::unique_ptr<char[]>, unsigned int);
+extern template void UDPHandle::send<IPv4>(Addr, std::unique_ptr<char[], BufferDeleter>, unsigned int);
+extern template void UDPHandle::send<IPv6>(Addr, std::unique_ptr<char[], BufferDeleter>, unsigned int);
 
 extern template void UDPHandle::send<IPv4>(const std::string &, unsigned int, char *, unsigned int);
 extern template void UDPHandle::send<IPv6>(const std::string &, unsigned int, char *, unsigned int);
@@ -623,14 +878,14 @@ extern template void UDPHandle::send<IPv6>(const std::string &, unsigned int, ch
 extern template void UDPHandle::send<IPv4>(Addr, char *, unsigned int);
 extern template void UDPHandle::send<IPv6>(Addr, char *, unsigned int);
 
-extern template int UDPHandle::trySend<IPv4>(const sockaddr &, std::unique_ptr<char[]>, unsigned int);
-extern template int UDPHandle::trySend<IPv6>(const sockaddr &, std::unique_ptr<char[]>, unsigned int);
+extern template int UDPHandle::trySend<IPv4>(const sockaddr &, std::unique_ptr<char[], BufferDeleter>, unsigned int);
+extern template int UDPHandle::trySend<IPv6>(const sockaddr &, std::unique_ptr<char[], BufferDeleter>, unsigned int);
 
-extern template int UDPHandle::trySend<IPv4>(const std::string &, unsigned int, std::unique_ptr<char[]>, unsigned int);
-extern template int UDPHandle::trySend<IPv6>(const std::string &, unsigned int, std::unique_ptr<char[]>, unsigned int);
+extern template int UDPHandle::trySend<IPv4>(const std::string &, unsigned int, std::unique_ptr<char[], BufferDeleter>, unsigned int);
+extern template int UDPHandle::trySend<IPv6>(const std::string &, unsigned int, std::unique_ptr<char[], BufferDeleter>, unsigned int);
 
-extern template int UDPHandle::trySend<IPv4>(Addr, std::unique_ptr<char[]>, unsigned int);
-extern template int UDPHandle::trySend<IPv6>(Addr, std::unique_ptr<char[]>, unsigned int);
+extern template int UDPHandle::trySend<IPv4>(Addr, std::unique_ptr<char[], BufferDeleter>, unsigned int);
+extern template int UDPHandle::trySend<IPv6>(Addr, std::unique_ptr<char[], BufferDeleter>, unsigned int);
 
 extern template int UDPHandle::trySend<IPv4>(const sockaddr &, char *, unsigned int);
 extern template int UDPHandle::trySend<IPv6>(const sockaddr &, char *, unsigned int);
@@ -641,6 +896,15 @@ extern template int UDPHandle::trySend<IPv6>(const std::string &, unsigned int,
 extern template int UDPHandle::trySend<IPv4>(Addr, char *, unsigned int);
 extern template int UDPHandle::trySend<IPv6>(Addr, char *, unsigned int);
 
+extern template int UDPHandle::trySend<IPv4>(const std::string &, unsigned int, char *, unsigned int, unsigned int);
+extern template int UDPHandle::trySend<IPv6>(const std::string &, unsigned int, char *, unsigned int, unsigned int);
+
+extern template int UDPHandle::trySend<IPv4>(Addr, char *, unsigned int, unsigned int);
+extern template int UDPHandle::trySend<IPv6>(Addr, char *, unsigned int, unsigned int);
+
+extern template void UDPHandle::sendBatch<IPv4>(std::vector<std::pair<Addr, Buffer>>);
+extern template void UDPHandle::sendBatch<IPv6>(std::vector<std::pair<Addr, Buffer>>);
+
 extern template void UDPHandle::recv<IPv4>();
 extern template void UDPHandle::recv<IPv6>();
 #endif // UVW_AS_LIB
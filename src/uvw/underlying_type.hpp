@@ -5,6 +5,7 @@
 #include <memory>
 #include <type_traits>
 #include <utility>
+#include "allocator.h"
 #include "loop.h"
 
 
@@ -39,6 +40,10 @@ protected:
         return reinterpret_cast<R *>(&other.resource);
     }
 
+    void rebind(std::shared_ptr<Loop> ref) noexcept {
+        pLoop = std::move(ref);
+    }
+
 public:
     explicit UnderlyingType(ConstructorAccess, std::shared_ptr<Loop> ref) noexcept
         : pLoop{std::move(ref)}, resource{}
@@ -61,7 +66,18 @@ public:
      */
     template<typename... Args>
     static std::shared_ptr<T> create(Args&&... args) {
-        return std::make_shared<T>(ConstructorAccess{0}, std::forward<Args>(args)...);
+        return std::allocate_shared<T>(details::AllocatorAdapter<T>{}, ConstructorAccess{0}, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Creates a new resource of the given type with an allocator.
+     * @param alloc The allocator to use for the resource.
+     * @param args Arguments to be forwarded to the actual constructor (if any).
+     * @return A pointer to the newly created resource.
+     */
+    template<typename Alloc, typename... Args>
+    static std::shared_ptr<T> allocate(const Alloc &alloc, Args&&... args) {
+        return std::allocate_shared<T>(alloc, ConstructorAccess{0}, std::forward<Args>(args)...);
     }
 
     /**
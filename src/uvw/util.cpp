@@ -3,6 +3,8 @@
 #endif
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 
 #include "config.h"
 
@@ -70,6 +72,140 @@ UVW_INLINE std::string UtsName::machine() const noexcept {
 }
 
 
+UVW_INLINE SockAddr::SockAddr() noexcept
+    : storage{}
+{
+    storage.ss_family = AF_UNSPEC;
+}
+
+
+UVW_INLINE SockAddr::SockAddr(const sockaddr &addr) noexcept
+    : SockAddr{}
+{
+    // typed copies, the actual object can be smaller than sockaddr_storage
+    if(addr.sa_family == AF_INET) {
+        reinterpret_cast<sockaddr_in &>(storage) = reinterpret_cast<const sockaddr_in &>(addr);
+    } else if(addr.sa_family == AF_INET6) {
+        reinterpret_cast<sockaddr_in6 &>(storage) = reinterpret_cast<const sockaddr_in6 &>(addr);
+    }
+}
+
+
+template<typename I>
+UVW_INLINE SockAddr SockAddr::parse(const std::string &ip, unsigned int port) noexcept {
+    SockAddr addr{};
+    auto *aptr = reinterpret_cast<typename details::IpTraits<I>::Type *>(&addr.storage);
+
+    if(port > 65535u || 0 != details::IpTraits<I>::addrFunc(ip.data(), static_cast<int>(port), aptr)) {
+        addr = SockAddr{};
+    }
+
+    return addr;
+}
+
+
+template<typename I>
+UVW_INLINE SockAddr SockAddr::parse(const Addr &addr) noexcept {
+    return parse<I>(addr.ip, addr.port);
+}
+
+
+UVW_INLINE int SockAddr::family() const noexcept {
+    return storage.ss_family;
+}
+
+
+UVW_INLINE std::string SockAddr::ip() const {
+    char name[details::DEFAULT_SIZE]{};
+
+    if(storage.ss_family == AF_INET) {
+        uv_ip4_name(reinterpret_cast<const sockaddr_in *>(&storage), name, sizeof(name));
+    } else if(storage.ss_family == AF_INET6) {
+        uv_ip6_name(reinterpret_cast<const sockaddr_in6 *>(&storage), name, sizeof(name));
+    }
+
+    return name;
+}
+
+
+UVW_INLINE unsigned int SockAddr::port() const noexcept {
+    if(storage.ss_family == AF_INET) {
+        return ntohs(reinterpret_cast<const sockaddr_in *>(&storage)->sin_port);
+    } else if(storage.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<const sockaddr_in6 *>(&storage)->sin6_port);
+    }
+
+    return 0u;
+}
+
+
+UVW_INLINE Addr SockAddr::addr() const {
+    return Addr{ip(), port()};
+}
+
+
+UVW_INLINE std::size_t SockAddr::size() const noexcept {
+    return storage.ss_family == AF_INET6 ? sizeof(sockaddr_in6) : (storage.ss_family == AF_INET ? sizeof(sockaddr_in) : sizeof(storage));
+}
+
+
+UVW_INLINE std::size_t SockAddr::hash() const noexcept {
+    // FNV-1a over the bytes that identify the address, padding excluded
+    // the state is 64-bit everywhere, it's truncated to the size of std::size_t at the end
+    auto mix = [](std::uint64_t value, const void *data, std::size_t len) {
+        for(auto *curr = static_cast<const unsigned char *>(data), *last = curr + len; curr != last; ++curr) {
+            value = (value ^ *curr) * std::uint64_t{1099511628211u};
+        }
+
+        return value;
+    };
+
+    auto value = mix(std::uint64_t{14695981039346656037u}, &storage.ss_family, sizeof(storage.ss_family));
+
+    if(storage.ss_family == AF_INET) {
+        const auto &addr = reinterpret_cast<const sockaddr_in &>(storage);
+        value = mix(mix(value, &addr.sin_addr, sizeof(addr.sin_addr)), &addr.sin_port, sizeof(addr.sin_port));
+    } else if(storage.ss_family == AF_INET6) {
+        const auto &addr = reinterpret_cast<const sockaddr_in6 &>(storage);
+        value = mix(mix(value, &addr.sin6_addr, sizeof(addr.sin6_addr)), &addr.sin6_port, sizeof(addr.sin6_port));
+        value = mix(value, &addr.sin6_scope_id, sizeof(addr.sin6_scope_id));
+    }
+
+    return static_cast<std::size_t>(value);
+}
+
+
+UVW_INLINE SockAddr::operator const sockaddr &() const noexcept {
+    return reinterpret_cast<const sockaddr &>(storage);
+}
+
+
+UVW_INLINE SockAddr::operator bool() const noexcept {
+    return storage.ss_family != AF_UNSPEC;
+}
+
+
+UVW_INLINE int SockAddr::compare(const SockAddr &other) const noexcept {
+    auto order = [](auto lhs, auto rhs) { return (lhs > rhs) - (lhs < rhs); };
+    int result = order(storage.ss_family, other.storage.ss_family);
+
+    if(0 == result && storage.ss_family == AF_INET) {
+        const auto &lhs = reinterpret_cast<const sockaddr_in &>(storage);
+        const auto &rhs = reinterpret_cast<const sockaddr_in &>(other.storage);
+        result = order(ntohl(lhs.sin_addr.s_addr), ntohl(rhs.sin_addr.s_addr));
+        result = result ? result : order(ntohs(lhs.sin_port), ntohs(rhs.sin_port));
+    } else if(0 == result && storage.ss_family == AF_INET6) {
+        const auto &lhs = reinterpret_cast<const sockaddr_in6 &>(storage);
+        const auto &rhs = reinterpret_cast<const sockaddr_in6 &>(other.storage);
+        result = order(std::memcmp(&lhs.sin6_addr, &rhs.sin6_addr, sizeof(lhs.sin6_addr)), 0);
+        result = result ? result : order(ntohs(lhs.sin6_port), ntohs(rhs.sin6_port));
+        result = result ? result : order(lhs.sin6_scope_id, rhs.sin6_scope_id);
+    }
+
+    return result;
+}
+
+
 UVW_INLINE PidType Utilities::OS::pid() noexcept {
     return uv_os_getpid();
 }
@@ -249,7 +385,23 @@ UVW_INLINE std::string Utilities::indexToIid(unsigned int index) noexcept {
 
 
 UVW_INLINE bool Utilities::replaceAllocator(MallocFuncType mallocFunc, ReallocFuncType reallocFunc, CallocFuncType callocFunc, FreeFuncType freeFunc) noexcept {
-    return (0 == uv_replace_allocator(mallocFunc, reallocFunc, callocFunc, freeFunc));
+    return replaceAllocator(Allocator{mallocFunc, reallocFunc, callocFunc, freeFunc});
+}
+
+
+UVW_INLINE bool Utilities::replaceAllocator(const Allocator &alloc) noexcept {
+    const bool ret = (0 == uv_replace_allocator(alloc.malloc, alloc.realloc, alloc.calloc, alloc.free));
+
+    if(ret) {
+        details::allocator() = alloc;
+    }
+
+    return ret;
+}
+
+
+UVW_INLINE Allocator Utilities::allocator() noexcept {
+    return details::allocator();
 }
 
 
@@ -343,4 +495,14 @@ UVW_INLINE void Utilities::sleep(unsigned int msec) noexcept {
 }
 
 
+// explicit instantiations
+#ifdef UVW_AS_LIB
+template SockAddr SockAddr::parse<IPv4>(const std::string &, unsigned int) noexcept;
+template SockAddr SockAddr::parse<IPv6>(const std::string &, unsigned int) noexcept;
+
+template SockAddr SockAddr::parse<IPv4>(const Addr &) noexcept;
+template SockAddr SockAddr::parse<IPv6>(const Addr &) noexcept;
+#endif // UVW_AS_LIB
+
+
 }
@@ -10,7 +10,9 @@
 #include <vector>
 #include <memory>
 #include <array>
+#include <functional>
 #include <uv.h>
+#include "allocator.h"
 
 
 namespace uvw {
@@ -324,6 +326,124 @@ struct Addr {
 };
 
 
+/**
+ * @brief Binary address representation.
+ *
+ * A trivially copyable wrapper around `sockaddr_storage`, meant for the hot
+ * paths where formatting an Addr for each packet is too expensive. Addresses
+ * are formatted only on demand and they can be compared and hashed as they
+ * are.<br/>
+ * A SockAddr converts to `const sockaddr &`, therefore it can be used with
+ * all the functions that accept an initialized `sockaddr_in` or
+ * `sockaddr_in6` data structure.
+ */
+class SockAddr {
+public:
+    /*! @brief Constructs an empty address of family `AF_UNSPEC`. */
+    SockAddr() noexcept;
+
+    /**
+     * @brief Constructs an address from a socket address.
+     *
+     * Families other than `AF_INET` and `AF_INET6` result in an empty address.
+     *
+     * @param addr Initialized `sockaddr_in` or `sockaddr_in6` data structure.
+     */
+    explicit SockAddr(const sockaddr &addr) noexcept;
+
+    /**
+     * @brief Parses and validates an address.
+     *
+     * The address is parsed once and for all, the result can be used to send
+     * data over and over without paying for the parsing each time.
+     *
+     * @param ip Either an IPv4 or an IPv6, according to the template
+     * parameter.
+     * @param port A valid service identifier.
+     * @return A valid address, an empty one in case of errors.
+     */
+    template<typename I = IPv4>
+    static SockAddr parse(const std::string &ip, unsigned int port) noexcept;
+
+    /**
+     * @brief Parses and validates an address.
+     * @param addr A valid instance of Addr.
+     * @return A valid address, an empty one in case of errors.
+     */
+    template<typename I = IPv4>
+    static SockAddr parse(const Addr &addr) noexcept;
+
+    /**
+     * @brief Gets the family of the address.
+     * @return `AF_INET`, `AF_INET6` or `AF_UNSPEC` for empty addresses.
+     */
+    int family() const noexcept;
+
+    /**
+     * @brief Formats the address.
+     * @return Either an IPv4 or an IPv6, an empty string for empty addresses.
+     */
+    std::string ip() const;
+
+    /**
+     * @brief Gets the port of the address.
+     * @return A valid service identifier, zero for empty addresses.
+     */
+    unsigned int port() const noexcept;
+
+    /**
+     * @brief Formats the address.
+     * @return A valid instance of Addr.
+     */
+    Addr addr() const;
+
+    /**
+     * @brief Gets the size of the underlying socket address.
+     * @return The size of the underlying socket address.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Gets a hash value for the address.
+     * @return A hash value for the address.
+     */
+    std::size_t hash() const noexcept;
+
+    /**
+     * @brief Gets the underlying socket address.
+     * @return A reference to the underlying socket address.
+     */
+    operator const sockaddr &() const noexcept;
+
+    /**
+     * @brief Checks if the address isn't empty.
+     * @return True if the address isn't empty, false otherwise.
+     */
+    explicit operator bool() const noexcept;
+
+    /**
+     * @brief Compares two addresses.
+     *
+     * Addresses are ordered by family, address and port.
+     *
+     * @param other The address to which to compare.
+     * @return A negative value, zero or a positive value if the address is
+     * respectively less than, equal to or greater than the other address.
+     */
+    int compare(const SockAddr &other) const noexcept;
+
+    friend bool operator==(const SockAddr &lhs, const SockAddr &rhs) noexcept { return lhs.compare(rhs) == 0; }
+    friend bool operator!=(const SockAddr &lhs, const SockAddr &rhs) noexcept { return lhs.compare(rhs) != 0; }
+    friend bool operator<(const SockAddr &lhs, const SockAddr &rhs) noexcept { return lhs.compare(rhs) < 0; }
+    friend bool operator<=(const SockAddr &lhs, const SockAddr &rhs) noexcept { return lhs.compare(rhs) <= 0; }
+    friend bool operator>(const SockAddr &lhs, const SockAddr &rhs) noexcept { return lhs.compare(rhs) > 0; }
+    friend bool operator>=(const SockAddr &lhs, const SockAddr &rhs) noexcept { return lhs.compare(rhs) >= 0; }
+
+private:
+    sockaddr_storage storage;
+};
+
+
 /**
  * \brief CPU information.
  */
@@ -428,7 +548,7 @@ std::string tryRead(F &&f, Args&&... args) noexcept {
     auto err = std::forward<F>(f)(args..., buf, &size);
 
     if(UV_ENOBUFS == err) {
-        std::unique_ptr<char[]> data{new char[size]};
+        std::unique_ptr<char, void(*)(void *)> data{static_cast<char *>(details::allocate(size)), &details::deallocate};
         err = std::forward<F>(f)(args..., data.get(), &size);
 
         if(0 == err) {
@@ -451,10 +571,10 @@ std::string tryRead(F &&f, Args&&... args) noexcept {
  * Miscellaneous functions that don’t really belong to any other class.
  */
 struct Utilities {
-    using MallocFuncType = void*(*)(size_t);
-    using ReallocFuncType = void*(*)(void*, size_t);
-    using CallocFuncType = void*(*)(size_t, size_t);
-    using FreeFuncType = void(*)(void*);
+    using MallocFuncType = Allocator::MallocFuncType;
+    using ReallocFuncType = Allocator::ReallocFuncType;
+    using CallocFuncType = Allocator::CallocFuncType;
+    using FreeFuncType = Allocator::FreeFuncType;
 
     /**
      * @brief OS dedicated utilities.
@@ -696,9 +816,11 @@ struct Utilities {
      *
      * Override the use of the standard library’s memory allocation
      * functions.<br/>
+     * The same functions serve the internal allocations of `uvw` on the hot
+     * paths (see Allocator for the details).<br/>
      * This method must be invoked before any other `uvw` function is called or
-     * after all resources have been freed and thus the underlying library
-     * doesn’t reference any allocated memory chunk.
+     * after all resources have been freed and thus neither `uvw` nor the
+     * underlying library reference any allocated memory chunk.
      *
      * If any of the function pointers is _null_, the invokation will fail.
      *
@@ -716,6 +838,23 @@ struct Utilities {
      */
     static bool replaceAllocator(MallocFuncType mallocFunc, ReallocFuncType reallocFunc, CallocFuncType callocFunc, FreeFuncType freeFunc) noexcept;
 
+    /**
+     * @brief Override the use of some standard library’s functions.
+     *
+     * See the overload that accepts the functions one by one for further
+     * details.
+     *
+     * @param alloc Replacement functions for memory allocation.
+     * @return True in case of success, false otherwise.
+     */
+    static bool replaceAllocator(const Allocator &alloc) noexcept;
+
+    /**
+     * @brief Gets the memory allocation functions in use.
+     * @return The memory allocation functions in use.
+     */
+    static Allocator allocator() noexcept;
+
     /**
      * @brief Gets the load average.
      * @return `[0,0,0]` on Windows (not available), the load average otherwise.
@@ -839,6 +978,43 @@ template<class... Func>
 Overloaded(Func...) -> Overloaded<Func...>;
 
 
+/**
+ * @cond TURN_OFF_DOXYGEN
+ * Internal details not to be documented.
+ */
+
+
+// (extern) explicit instantiations
+#ifdef UVW_AS_LIB
+extern template SockAddr SockAddr::parse<IPv4>(const std::string &, unsigned int) noexcept;
+extern template SockAddr SockAddr::parse<IPv6>(const std::string &, unsigned int) noexcept;
+
+extern template SockAddr SockAddr::parse<IPv4>(const Addr &) noexcept;
+extern template SockAddr SockAddr::parse<IPv6>(const Addr &) noexcept;
+#endif // UVW_AS_LIB
+
+
+/**
+ * Internal details not to be documented.
+ * @endcond
+ */
+
+
+}
+
+
+/**
+ * @brief Hash support for SockAddr.
+ */
+namespace std {
+
+
+template<>
+struct hash<uvw::SockAddr> {
+    std::size_t operator()(const uvw::SockAddr &addr) const noexcept { return addr.hash(); }
+};
+
+
 }
 
 
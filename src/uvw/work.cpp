@@ -11,7 +11,7 @@ namespace uvw {
 
 
 UVW_INLINE WorkReq::WorkReq(ConstructorAccess ca, std::shared_ptr<Loop> ref, InternalTask t)
-    : Request{ca, std::move(ref)}, task{t}
+    : Request{ca, std::move(ref)}, task{std::move(t)}
 {}
 
 
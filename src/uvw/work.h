@@ -2,9 +2,9 @@
 #define UVW_WORK_INCLUDE_H
 
 
-#include <functional>
 #include <memory>
 #include <uv.h>
+#include "function.hpp"
 #include "request.hpp"
 #include "loop.h"
 
@@ -28,14 +28,14 @@ struct WorkEvent {};
  *
  * To create a `WorkReq` through a `Loop`, arguments follow:
  *
- * * A valid instance of a `Task`, that is of type `std::function<void(void)>`.
+ * * A valid instance of a `Task`, that is of type `Function<void(void)>`.
  *
  * See the official
  * [documentation](http://docs.libuv.org/en/v1.x/threadpool.html)
  * for further details.
  */
 class WorkReq final: public Request<WorkReq, uv_work_t> {
-    using InternalTask = std::function<void(void)>;
+    using InternalTask = Function<void(void)>;
 
     static void workCallback(uv_work_t *req);
 
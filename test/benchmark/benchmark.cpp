@@ -0,0 +1,254 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <gtest/gtest.h>
+#include <uvw/emitter.h>
+#include <uvw/server.h>
+#include <uvw/timer.h>
+#include <uvw/udp.h>
+
+
+struct Timer final {
+    Timer(): start{std::chrono::system_clock::now()} {}
+
+    void elapsed() {
+        auto now = std::chrono::system_clock::now();
+        std::cout << std::chrono::duration<double>(now - start).count() << " seconds" << std::endl;
+    }
+
+private:
+    std::chrono::time_point<std::chrono::system_clock> start;
+};
+
+
+template<std::size_t>
+struct BenchmarkEvent {};
+
+struct BenchmarkEmitter: uvw::Emitter<BenchmarkEmitter> {
+    template<typename E>
+    void emit() { publish(E{}); }
+};
+
+
+TEST(Benchmark, EmitterPublish) {
+    BenchmarkEmitter emitter{};
+    std::size_t counter{};
+
+    emitter.on<BenchmarkEvent<0>>([&counter](const auto &, auto &) { ++counter; });
+    emitter.on<BenchmarkEvent<1>>([&counter](const auto &, auto &) { ++counter; });
+    emitter.on<BenchmarkEvent<2>>([&counter](const auto &, auto &) { ++counter; });
+    emitter.on<BenchmarkEvent<3>>([&counter](const auto &, auto &) { ++counter; });
+
+    std::cout << "Publishing 10000000 events" << std::endl;
+
+    Timer timer;
+
+    for(std::size_t i = 0; i < 2500000; ++i) {
+        emitter.emit<BenchmarkEvent<0>>();
+        emitter.emit<BenchmarkEvent<1>>();
+        emitter.emit<BenchmarkEvent<2>>();
+        emitter.emit<BenchmarkEvent<3>>();
+    }
+
+    timer.elapsed();
+
+    ASSERT_EQ(counter, 10000000u);
+}
+
+
+TEST(Benchmark, EmitterOnce) {
+    BenchmarkEmitter emitter{};
+    std::size_t counter{};
+
+    std::cout << "Registering and publishing 1000000 once listeners" << std::endl;
+
+    Timer timer;
+
+    for(std::size_t i = 0; i < 1000000; ++i) {
+        emitter.once<BenchmarkEvent<0>>([&counter](const auto &, auto &) { ++counter; });
+        emitter.emit<BenchmarkEvent<0>>();
+    }
+
+    timer.elapsed();
+
+    ASSERT_EQ(counter, 1000000u);
+}
+
+
+template<typename Server>
+void ServerBenchmark(Server &server, std::size_t count) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+    // bounded number of connections in flight, not to run out of descriptors
+    const std::size_t concurrency = 64u;
+
+    auto loop = uvw::Loop::create();
+    std::size_t started{};
+    std::size_t closed{};
+
+    ASSERT_TRUE(server.start(address, port));
+
+    auto connect = [&](auto &self) -> void {
+        if(started < count) {
+            auto client = loop->template resource<uvw::TCPHandle>();
+
+            client->template on<uvw::ConnectEvent>([](const auto &, auto &handle) { handle.read(); });
+            client->template on<uvw::EndEvent>([](const auto &, auto &handle) { handle.close(); });
+            client->template on<uvw::ErrorEvent>([](const auto &, auto &handle) { handle.close(); });
+            client->template on<uvw::CloseEvent>([&closed, &self](const auto &, auto &) { ++closed; self(self); });
+
+            client->connect(address, port);
+            ++started;
+        }
+    };
+
+    Timer timer;
+
+    for(std::size_t i = 0; i < concurrency; ++i) {
+        connect(connect);
+    }
+
+    loop->run();
+    timer.elapsed();
+
+    server.stop();
+    loop->close();
+
+    ASSERT_EQ(closed, count);
+}
+
+
+TEST(Benchmark, ReusePortServer) {
+    uvw::ReusePortServer server{[](uvw::TCPHandle &handle) { handle.close(); }, 4u};
+
+    std::cout << "Accepting 10000 connections on 4 loops (SO_REUSEPORT)" << std::endl;
+
+#ifdef SO_REUSEPORT
+    ServerBenchmark(server, 10000u);
+#endif
+}
+
+
+TEST(Benchmark, DispatchServer) {
+    uvw::DispatchServer server{[](uvw::TCPHandle &handle) { handle.close(); }, 4u};
+
+    std::cout << "Accepting 10000 connections on 4 loops (dispatch)" << std::endl;
+
+#ifndef _WIN32
+    ServerBenchmark(server, 10000u);
+#endif
+}
+
+
+template<typename Func>
+void UDPSendBenchmark(Func func) {
+    auto loop = uvw::Loop::getDefault();
+    auto handle = loop->resource<uvw::UDPHandle>();
+    std::size_t sent{};
+
+    handle->bind(uvw::Addr{"127.0.0.1", 4242});
+
+    std::cout << "Sending 200000 datagrams" << std::endl;
+
+    Timer timer;
+
+    for(std::size_t i = 0; i < 200000; ++i) {
+        sent += (func(*handle) == 1);
+    }
+
+    timer.elapsed();
+
+    handle->close();
+    loop->run();
+
+    ASSERT_EQ(sent, 200000u);
+}
+
+
+TEST(Benchmark, UDPSendAddr) {
+    const uvw::Addr addr{"127.0.0.1", 4243};
+    char data[] = { 'x' };
+
+    UDPSendBenchmark([&](uvw::UDPHandle &handle) {
+        return handle.trySend(addr, data, 1u);
+    });
+}
+
+
+TEST(Benchmark, UDPSendSockAddr) {
+    const auto addr = uvw::SockAddr::parse("127.0.0.1", 4243);
+    char data[] = { 'x' };
+
+    UDPSendBenchmark([&](uvw::UDPHandle &handle) {
+        return handle.trySend(addr, data, 1u);
+    });
+}
+
+
+TEST(Benchmark, SockAddrParse) {
+    const uvw::Addr addr{"127.0.0.1", 4243};
+    const auto dest = uvw::SockAddr::parse(addr);
+    std::size_t valid{};
+
+    std::cout << "Preparing 10000000 destinations, parsing each time" << std::endl;
+
+    Timer parse;
+
+    for(std::size_t i = 0; i < 10000000; ++i) {
+        valid += static_cast<bool>(uvw::SockAddr::parse(addr));
+    }
+
+    parse.elapsed();
+
+    std::cout << "Preparing 10000000 destinations, parsing once" << std::endl;
+
+    Timer copy;
+
+    for(std::size_t i = 0; i < 10000000; ++i) {
+        uvw::SockAddr curr = dest;
+        valid += static_cast<bool>(curr);
+    }
+
+    copy.elapsed();
+
+    ASSERT_EQ(valid, 20000000u);
+}
+
+
+void HandleChurnBenchmark(bool slabs) {
+    auto loop = uvw::Loop::create();
+    std::size_t closed{};
+
+    loop->slabs(slabs);
+
+    std::cout << "Opening and closing 1000000 timers, 1000 at a time" << std::endl;
+
+    Timer timer;
+
+    for(std::size_t i = 0; i < 1000; ++i) {
+        for(std::size_t j = 0; j < 1000; ++j) {
+            auto handle = loop->resource<uvw::TimerHandle>();
+            handle->once<uvw::CloseEvent>([&closed](const auto &, auto &) { ++closed; });
+            handle->close();
+        }
+
+        loop->run();
+    }
+
+    timer.elapsed();
+
+    loop->close();
+
+    ASSERT_EQ(closed, 1000000u);
+}
+
+
+TEST(Benchmark, HandleChurn) {
+    HandleChurnBenchmark(false);
+}
+
+
+TEST(Benchmark, HandleChurnSlabs) {
+    HandleChurnBenchmark(true);
+}
@@ -0,0 +1,67 @@
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <uvw/allocator.h>
+#include <uvw/timer.h>
+#include <uvw/util.h>
+
+
+static std::size_t live = 0u;
+
+
+static void * countingMalloc(std::size_t size) {
+    ++live;
+    return std::malloc(size);
+}
+
+
+static void * countingRealloc(void *ptr, std::size_t size) {
+    live += !ptr;
+    return std::realloc(ptr, size);
+}
+
+
+static void * countingCalloc(std::size_t count, std::size_t size) {
+    ++live;
+    return std::calloc(count, size);
+}
+
+
+static void countingFree(void *ptr) {
+    live -= !!ptr;
+    std::free(ptr);
+}
+
+
+TEST(Allocator, Functionalities) {
+    const auto prev = uvw::Utilities::allocator();
+
+    ASSERT_NE(prev.malloc, nullptr);
+    ASSERT_NE(prev.free, nullptr);
+    ASSERT_FALSE(uvw::Utilities::replaceAllocator(uvw::Allocator{nullptr, nullptr, nullptr, nullptr}));
+    ASSERT_EQ(uvw::Utilities::allocator().malloc, prev.malloc);
+    ASSERT_TRUE(uvw::Utilities::replaceAllocator(uvw::Allocator{&countingMalloc, &countingRealloc, &countingCalloc, &countingFree}));
+    ASSERT_EQ(uvw::Utilities::allocator().malloc, &countingMalloc);
+
+    {
+        auto loop = uvw::Loop::create();
+        auto handle = loop->resource<uvw::TimerHandle>();
+        bool checkCloseEvent = false;
+
+        ASSERT_NE(live, 0u);
+
+        handle->on<uvw::CloseEvent>([&checkCloseEvent](const auto &, auto &) {
+            ASSERT_FALSE(checkCloseEvent);
+            checkCloseEvent = true;
+        });
+
+        handle->close();
+        handle.reset();
+        loop->run();
+        loop->close();
+
+        ASSERT_TRUE(checkCloseEvent);
+    }
+
+    ASSERT_EQ(live, 0u);
+    ASSERT_TRUE(uvw::Utilities::replaceAllocator(prev));
+}
@@ -0,0 +1,201 @@
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <uvw/buffer.h>
+#include <uvw/loop.h>
+#include <uvw/udp.h>
+
+
+TEST(BufferDeleter, Functionalities) {
+    std::unique_ptr<char[], uvw::BufferDeleter> buf = std::unique_ptr<char[]>{new char[4]};
+    bool released = false;
+
+    ASSERT_NE(buf, nullptr);
+
+    buf.reset();
+
+    buf = std::unique_ptr<char[], uvw::BufferDeleter>{new char[4], uvw::BufferDeleter{[](char *ptr, void *payload) noexcept {
+        *static_cast<bool *>(payload) = true;
+        delete[] ptr;
+    }, &released}};
+
+    ASSERT_FALSE(released);
+
+    buf.reset();
+
+    ASSERT_TRUE(released);
+}
+
+
+TEST(BufferPool, Functionalities) {
+    auto loop = uvw::Loop::create();
+    auto &pool = loop->bufferPool();
+
+    ASSERT_EQ(pool.limit(), uvw::BufferPool::DEFAULT_LIMIT);
+
+    auto buf = pool.allocate(100u);
+
+    ASSERT_NE(buf, nullptr);
+    ASSERT_EQ(pool.stats().used, 1024u);
+    ASSERT_EQ(pool.stats().pooled, 0u);
+    ASSERT_EQ(pool.stats().misses, 1u);
+    ASSERT_EQ(pool.stats().hits, 0u);
+
+    const char *ptr = buf.get();
+    buf.reset();
+
+    ASSERT_EQ(pool.stats().used, 0u);
+    ASSERT_EQ(pool.stats().pooled, 1024u);
+
+    buf = pool.allocate(1024u);
+
+    ASSERT_EQ(buf.get(), ptr);
+    ASSERT_EQ(pool.stats().hits, 1u);
+    ASSERT_EQ(pool.stats().pooled, 0u);
+
+    auto other = pool.allocate(1025u);
+
+    ASSERT_NE(other.get(), ptr);
+    ASSERT_EQ(pool.stats().used, 1024u + 2048u);
+
+    auto large = pool.allocate(1u << 20u);
+    large.reset();
+
+    ASSERT_EQ(pool.stats().used, 1024u + 2048u);
+    ASSERT_EQ(pool.stats().pooled, 0u);
+
+    buf.reset();
+    other.reset();
+
+    ASSERT_EQ(pool.stats().pooled, 1024u + 2048u);
+
+    pool.clear();
+
+    ASSERT_EQ(pool.stats().pooled, 0u);
+    ASSERT_EQ(pool.stats().misses, 3u);
+
+    loop->close();
+}
+
+
+TEST(BufferPool, Limit) {
+    auto loop = uvw::Loop::create();
+    auto &pool = loop->bufferPool();
+
+    auto first = pool.allocate(4096u);
+    auto second = pool.allocate(4096u);
+
+    pool.limit(4096u);
+
+    ASSERT_EQ(pool.limit(), 4096u);
+
+    first.reset();
+    second.reset();
+
+    ASSERT_EQ(pool.stats().pooled, 4096u);
+
+    pool.limit(0u);
+
+    ASSERT_EQ(pool.stats().pooled, 0u);
+
+    loop->close();
+}
+
+
+TEST(BufferPool, OutliveLoop) {
+    auto loop = uvw::Loop::create();
+    auto buf = loop->bufferPool().allocate(512u);
+
+    buf[0] = 'x';
+    loop->close();
+    loop.reset();
+
+    ASSERT_EQ(buf[0], 'x');
+
+    buf.reset();
+}
+
+
+TEST(BufferPool, ReleaseWhileAlive) {
+    auto loop = uvw::Loop::create();
+    auto &pool = loop->bufferPool();
+    std::vector<std::unique_ptr<char[], uvw::BufferDeleter>> buffers{};
+
+    for(std::size_t i = 0; i < 64u; ++i) {
+        buffers.push_back(pool.allocate(1024u));
+    }
+
+    std::thread worker{[&buffers]() {
+        for(std::size_t i = 0; i < 32u; ++i) {
+            buffers[i].reset();
+        }
+    }};
+
+    for(std::size_t i = 32u; i < 64u; ++i) {
+        buffers[i].reset();
+    }
+
+    worker.join();
+
+    ASSERT_EQ(pool.stats().used, 0u);
+    ASSERT_EQ(pool.stats().pooled, 64u * 1024u);
+
+    auto buf = pool.allocate(1024u);
+
+    ASSERT_EQ(pool.stats().hits, 1u);
+
+    buf.reset();
+    loop->close();
+}
+
+
+TEST(BufferPool, ReleaseFromOtherThread) {
+    auto loop = uvw::Loop::create();
+    auto first = loop->bufferPool().allocate(512u);
+    auto second = loop->bufferPool().allocate(4096u);
+
+    loop->close();
+    loop.reset();
+
+    std::thread worker{[&first]() { first.reset(); }};
+    second.reset();
+    worker.join();
+
+    ASSERT_EQ(first, nullptr);
+}
+
+
+TEST(BufferPool, Recv) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::UDPHandle>();
+    auto client = loop->resource<uvw::UDPHandle>();
+    std::unique_ptr<char[], uvw::BufferDeleter> data{};
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::UDPDataEvent>([&client, &data](uvw::UDPDataEvent &event, uvw::UDPHandle &handle) {
+        data = std::move(event.data);
+        client->close();
+        handle.close();
+    });
+
+    server->bind(uvw::Addr{address, port});
+    server->recv();
+
+    auto msg = std::unique_ptr<char[]>(new char[]{ 'f', 'o', 'o' });
+    client->trySend(uvw::Addr{address, port}, std::move(msg), 3);
+
+    loop->run();
+
+    ASSERT_NE(data, nullptr);
+    ASSERT_GT(loop->bufferPool().stats().used, 0u);
+
+    data.reset();
+
+    ASSERT_EQ(loop->bufferPool().stats().used, 0u);
+}
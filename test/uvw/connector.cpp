@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <uvw/connector.h>
+
+
+TEST(TCPConnector, Connect) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::TCPHandle>();
+    auto connector = uvw::TCPConnector::create(loop);
+
+    bool checkListenEvent = false;
+    bool checkConnectorEvent = false;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    connector->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::ListenEvent>([&checkListenEvent](const uvw::ListenEvent &, uvw::TCPHandle &handle) {
+        ASSERT_FALSE(checkListenEvent);
+        checkListenEvent = true;
+        auto socket = handle.loop().resource<uvw::TCPHandle>();
+        socket->on<uvw::EndEvent>([](const uvw::EndEvent &, uvw::TCPHandle &sock) { sock.close(); });
+        handle.accept(*socket);
+        socket->read();
+        handle.close();
+    });
+
+    connector->on<uvw::ConnectorEvent>([&](const uvw::ConnectorEvent &event, uvw::TCPConnector &conn) {
+        ASSERT_FALSE(checkConnectorEvent);
+        ASSERT_FALSE(conn.pending());
+        ASSERT_NE(event.handle, nullptr);
+        ASSERT_EQ(event.handle->peer().ip, address);
+        ASSERT_EQ(event.handle->peer().port, port);
+        checkConnectorEvent = true;
+        event.handle->close();
+    });
+
+    server->bind(address, port);
+    server->listen();
+
+    connector->connect("localhost", port);
+
+    ASSERT_TRUE(connector->pending());
+
+    loop->run();
+
+    ASSERT_TRUE(checkListenEvent);
+    ASSERT_TRUE(checkConnectorEvent);
+}
+
+
+TEST(TCPConnector, Refused) {
+    auto loop = uvw::Loop::getDefault();
+    auto connector = uvw::TCPConnector::create(loop);
+
+    bool checkErrorEvent = false;
+
+    connector->on<uvw::ConnectorEvent>([](const auto &, auto &) { FAIL(); });
+
+    connector->on<uvw::ErrorEvent>([&checkErrorEvent](const uvw::ErrorEvent &event, uvw::TCPConnector &conn) {
+        ASSERT_FALSE(checkErrorEvent);
+        ASSERT_FALSE(conn.pending());
+        ASSERT_EQ(event.code(), UV_ECONNREFUSED);
+        checkErrorEvent = true;
+    });
+
+    connector->attemptDelay(uvw::TCPConnector::Time{10});
+    connector->connect("127.0.0.1", 4242);
+    loop->run();
+
+    ASSERT_TRUE(checkErrorEvent);
+}
+
+
+TEST(TCPConnector, Cancel) {
+    auto loop = uvw::Loop::getDefault();
+    auto connector = uvw::TCPConnector::create(loop);
+
+    connector->on<uvw::ConnectorEvent>([](const auto &, auto &) { FAIL(); });
+    connector->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    connector->connect("localhost", 4242);
+    connector->cancel();
+
+    ASSERT_FALSE(connector->pending());
+
+    loop->run();
+}
@@ -5,8 +5,21 @@
 
 struct FakeEvent { };
 
+struct CountingEvent {
+    CountingEvent() = default;
+    CountingEvent(const CountingEvent &other): value{other.value} { ++copies; }
+    CountingEvent(CountingEvent &&other): value{other.value} { ++moves; }
+
+    inline static int copies{};
+    inline static int moves{};
+    int value{};
+};
+
 struct TestEmitter: uvw::Emitter<TestEmitter> {
     void emit() { publish(FakeEvent{}); }
+    void emit(CountingEvent &event) { publish(event); }
+    void emit(const CountingEvent &event) { publish(event); }
+    void emit(CountingEvent &&event) { publish(std::move(event)); }
 };
 
 
@@ -152,3 +165,105 @@ TEST(Emitter, CallbackClear) {
     ASSERT_FALSE(emitter.empty());
     ASSERT_FALSE(emitter.empty<FakeEvent>());
 }
+
+
+TEST(Emitter, Lookup) {
+    TestEmitter emitter{};
+
+    emitter.emit();
+
+    ASSERT_TRUE(emitter.empty());
+    ASSERT_TRUE(emitter.empty<FakeEvent>());
+
+    ASSERT_EQ(uvw::type<FakeEvent>(), uvw::type<FakeEvent>());
+    ASSERT_NE(uvw::type<FakeEvent>(), uvw::type<uvw::ErrorEvent>());
+
+    emitter.on<FakeEvent>([](const auto &, auto &){});
+
+    ASSERT_FALSE(emitter.empty());
+    ASSERT_TRUE(emitter.empty<uvw::ErrorEvent>());
+}
+
+
+TEST(Emitter, EraseDuringPublish) {
+    TestEmitter emitter{};
+    TestEmitter::Connection<FakeEvent> conn{};
+    int counter{};
+
+    emitter.on<FakeEvent>([&counter](const auto &, auto &) { ++counter; });
+    conn = emitter.on<FakeEvent>([&counter](const auto &, auto &) { ++counter; });
+
+    emitter.on<FakeEvent>([&conn](const auto &, auto &ref) {
+        ref.erase(conn);
+    });
+
+    emitter.emit();
+
+    ASSERT_EQ(counter, 1);
+
+    emitter.erase(conn);
+    emitter.emit();
+
+    ASSERT_EQ(counter, 2);
+    ASSERT_FALSE(emitter.empty<FakeEvent>());
+}
+
+
+TEST(Emitter, OnceDuringPublish) {
+    TestEmitter emitter{};
+    int counter{};
+
+    emitter.once<FakeEvent>([&counter](const auto &, auto &ref) {
+        ++counter;
+        ref.template once<FakeEvent>([&counter](const auto &, auto &) { ++counter; });
+        ASSERT_FALSE(ref.empty());
+    });
+
+    emitter.emit();
+
+    ASSERT_EQ(counter, 1);
+    ASSERT_FALSE(emitter.empty<FakeEvent>());
+
+    emitter.emit();
+
+    ASSERT_EQ(counter, 2);
+    ASSERT_TRUE(emitter.empty<FakeEvent>());
+}
+
+
+TEST(Emitter, PublishByReference) {
+    TestEmitter emitter{};
+    const CountingEvent *last{};
+
+    // listeners are invoked in reverse order
+    emitter.on<CountingEvent>([&last](auto &event, auto &) {
+        ASSERT_EQ(last, &event);
+    });
+
+    emitter.on<CountingEvent>([&last](auto &event, auto &) {
+        last = &event;
+        ++event.value;
+    });
+
+    CountingEvent::copies = CountingEvent::moves = 0;
+
+    emitter.emit(CountingEvent{});
+
+    ASSERT_EQ(CountingEvent::copies, 0);
+    ASSERT_EQ(CountingEvent::moves, 0);
+
+    CountingEvent borrowed{};
+    emitter.emit(borrowed);
+
+    ASSERT_EQ(last, &borrowed);
+    ASSERT_EQ(borrowed.value, 1);
+    ASSERT_EQ(CountingEvent::copies, 0);
+    ASSERT_EQ(CountingEvent::moves, 0);
+
+    const CountingEvent constant{};
+    emitter.emit(constant);
+
+    ASSERT_EQ(constant.value, 0);
+    ASSERT_EQ(CountingEvent::copies, 1);
+    ASSERT_EQ(CountingEvent::moves, 0);
+}
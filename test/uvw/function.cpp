@@ -0,0 +1,127 @@
+#include <cstddef>
+#include <cstdlib>
+#include <array>
+#include <functional>
+#include <memory>
+#include <new>
+#include <gtest/gtest.h>
+#include <uvw/function.hpp>
+#include <uvw/util.h>
+
+
+static std::size_t allocations{};
+
+
+static void * countingMalloc(std::size_t size) {
+    ++allocations;
+    return std::malloc(size);
+}
+
+
+static int sum(int lhs, int rhs) { return lhs + rhs; }
+
+
+TEST(Function, Functionalities) {
+    uvw::Function<int(int, int)> func{};
+
+    ASSERT_FALSE(func);
+
+    func = &sum;
+
+    ASSERT_TRUE(func);
+    ASSERT_EQ(func(1, 2), 3);
+
+    func = [value = 40](int lhs, int rhs) { return value + lhs + rhs; };
+
+    ASSERT_TRUE(func);
+    ASSERT_EQ(func(1, 1), 42);
+
+    auto other = std::move(func);
+
+    ASSERT_FALSE(func);
+    ASSERT_TRUE(other);
+    ASSERT_EQ(other(0, 2), 42);
+
+    other = nullptr;
+
+    ASSERT_FALSE(other);
+
+    int (*null)(int, int) = nullptr;
+    func = null;
+
+    ASSERT_FALSE(func);
+}
+
+
+TEST(Function, MoveOnly) {
+    auto ptr = std::make_unique<int>(42);
+    uvw::Function<int()> func = [ptr = std::move(ptr)]() { return *ptr; };
+    uvw::Function<int()> other{std::move(func)};
+
+    ASSERT_FALSE(func);
+    ASSERT_EQ(other(), 42);
+}
+
+
+TEST(Function, DiscardResult) {
+    int value = 0;
+    uvw::Function<void(int)> func = [&value](int other) { return value = other; };
+
+    func(42);
+
+    ASSERT_EQ(value, 42);
+}
+
+
+TEST(Function, Empty) {
+    uvw::Function<int(int, int)> func{};
+
+    ASSERT_THROW(func(1, 2), std::bad_function_call);
+
+    func = &sum;
+    auto other = std::move(func);
+
+    ASSERT_THROW(func(1, 2), std::bad_function_call);
+    ASSERT_EQ(other(1, 2), 3);
+
+    other = nullptr;
+
+    ASSERT_THROW(other(1, 2), std::bad_function_call);
+}
+
+
+TEST(Function, Storage) {
+    auto ptr = std::make_shared<int>(42);
+    auto small = [ptr](int value) { return *ptr + value; };
+    auto large = [ptr, pad = std::array<char, 64u>{}](int value) { return *ptr + value + pad[0]; };
+
+    ASSERT_TRUE(uvw::Function<int(int)>::fits<decltype(small)>());
+    ASSERT_FALSE(uvw::Function<int(int)>::fits<decltype(large)>());
+    ASSERT_TRUE((uvw::Function<int(int), 128u>::fits<decltype(large)>()));
+
+    // spilled targets draw from the allocation functions in use
+    const auto prev = uvw::Utilities::allocator();
+    ASSERT_TRUE(uvw::Utilities::replaceAllocator(uvw::Allocator{&countingMalloc, prev.realloc, prev.calloc, prev.free}));
+    const auto before = allocations;
+
+    {
+        uvw::Function<int(int)> func{small};
+        uvw::Function<int(int)> other{std::move(func)};
+        ASSERT_EQ(other(0), 42);
+        ASSERT_EQ(ptr.use_count(), 4);
+    }
+
+    ASSERT_EQ(allocations, before);
+    ASSERT_EQ(ptr.use_count(), 3);
+
+    {
+        uvw::Function<int(int)> func{large};
+        uvw::Function<int(int)> other{std::move(func)};
+        ASSERT_EQ(other(0), 42);
+        ASSERT_EQ(ptr.use_count(), 4);
+    }
+
+    ASSERT_EQ(allocations, before + 1u);
+    ASSERT_EQ(ptr.use_count(), 3);
+    ASSERT_TRUE(uvw::Utilities::replaceAllocator(prev));
+}
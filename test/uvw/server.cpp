@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <uvw.hpp>
+
+
+TEST(ReusePortServer, StartAndStop) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+    const std::size_t count = 8u;
+
+    uvw::ReusePortServer server{[](uvw::TCPHandle &handle) { handle.close(); }, 2u};
+
+    ASSERT_EQ(server.size(), 2u);
+
+#ifdef SO_REUSEPORT
+    ASSERT_TRUE(server.start(address, port));
+    ASSERT_FALSE(server.start(address, port));
+
+    auto loop = uvw::Loop::getDefault();
+    std::size_t closed = 0u;
+
+    for(auto pos = 0u; pos < count; ++pos) {
+        auto client = loop->resource<uvw::TCPHandle>();
+
+        client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+        client->on<uvw::ConnectEvent>([](const uvw::ConnectEvent &, uvw::TCPHandle &handle) { handle.read(); });
+        client->on<uvw::EndEvent>([](const uvw::EndEvent &, uvw::TCPHandle &handle) { handle.close(); });
+        client->on<uvw::CloseEvent>([&closed](const uvw::CloseEvent &, uvw::TCPHandle &) { ++closed; });
+
+        client->connect(address, port);
+    }
+
+    loop->run();
+
+    ASSERT_EQ(closed, count);
+    ASSERT_EQ(server.accepted(0u) + server.accepted(1u), count);
+
+    server.stop();
+
+    ASSERT_EQ(server.connections(0u) + server.connections(1u), 0u);
+    ASSERT_TRUE(server.start(address, port));
+#else
+    ASSERT_FALSE(server.start(address, port));
+#endif
+}
+
+
+TEST(DispatchServer, StartAndStop) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+    const std::size_t count = 8u;
+
+    uvw::DispatchServer server{[](uvw::TCPHandle &handle) { handle.close(); }, 2u, uvw::DispatchServer::Policy::ROUND_ROBIN};
+
+    ASSERT_EQ(server.size(), 2u);
+
+#ifndef _WIN32
+    ASSERT_TRUE(server.start(address, port));
+    ASSERT_FALSE(server.start(address, port));
+
+    auto loop = uvw::Loop::getDefault();
+    std::size_t closed = 0u;
+
+    for(auto pos = 0u; pos < count; ++pos) {
+        auto client = loop->resource<uvw::TCPHandle>();
+
+        client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+        client->on<uvw::ConnectEvent>([](const uvw::ConnectEvent &, uvw::TCPHandle &handle) { handle.read(); });
+        client->on<uvw::EndEvent>([](const uvw::EndEvent &, uvw::TCPHandle &handle) { handle.close(); });
+        client->on<uvw::CloseEvent>([&closed](const uvw::CloseEvent &, uvw::TCPHandle &) { ++closed; });
+
+        client->connect(address, port);
+    }
+
+    loop->run();
+
+    ASSERT_EQ(closed, count);
+    ASSERT_EQ(server.accepted(0u), count / 2u);
+    ASSERT_EQ(server.accepted(1u), count / 2u);
+
+    server.stop();
+
+    ASSERT_EQ(server.connections(0u) + server.connections(1u), 0u);
+#else
+    ASSERT_FALSE(server.start(address, port));
+#endif
+}
+
+
+TEST(DispatchServer, LeastConnections) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+    const std::size_t count = 8u;
+
+    // connections are kept open, each one goes to the least loaded worker
+    uvw::DispatchServer server{[](uvw::TCPHandle &handle) { handle.read(); }, 4u};
+
+#ifndef _WIN32
+    ASSERT_TRUE(server.start(address, port));
+
+    auto loop = uvw::Loop::getDefault();
+    auto timer = loop->resource<uvw::TimerHandle>();
+    std::size_t connected = 0u;
+
+    timer->on<uvw::TimerEvent>([&server, count](const uvw::TimerEvent &, uvw::TimerHandle &handle) {
+        std::size_t total = 0u;
+
+        for(auto pos = 0u; pos < server.size(); ++pos) {
+            total += server.accepted(pos);
+        }
+
+        if(total == count) {
+            handle.loop().walk([](auto &&h) { h.close(); });
+        }
+    });
+
+    for(auto pos = 0u; pos < count; ++pos) {
+        auto client = loop->resource<uvw::TCPHandle>();
+
+        client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+        client->on<uvw::ConnectEvent>([&connected](const uvw::ConnectEvent &, uvw::TCPHandle &) { ++connected; });
+
+        client->connect(address, port);
+    }
+
+    timer->start(uvw::TimerHandle::Time{10}, uvw::TimerHandle::Time{10});
+    loop->run();
+
+    ASSERT_EQ(connected, count);
+
+    for(auto pos = 0u; pos < server.size(); ++pos) {
+        ASSERT_EQ(server.accepted(pos), count / server.size());
+        ASSERT_EQ(server.connections(pos), count / server.size());
+    }
+
+    server.stop();
+#endif
+}
@@ -0,0 +1,80 @@
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+#include <uvw/idle.h>
+#include <uvw/slab.h>
+#include <uvw/timer.h>
+
+
+TEST(SlabPool, Functionalities) {
+    auto loop = uvw::Loop::create();
+
+    ASSERT_FALSE(loop->slabs());
+
+    auto heap = loop->resource<uvw::TimerHandle>();
+
+    ASSERT_EQ(loop->slabStats<uvw::TimerHandle>().capacity, 0u);
+
+    loop->slabs(true);
+
+    ASSERT_TRUE(loop->slabs());
+
+    std::vector<std::shared_ptr<uvw::TimerHandle>> timers;
+
+    for(auto i = 0; i < 100; ++i) {
+        timers.push_back(loop->resource<uvw::TimerHandle>());
+    }
+
+    auto stats = loop->slabStats<uvw::TimerHandle>();
+
+    ASSERT_GE(stats.size, sizeof(uvw::TimerHandle));
+    ASSERT_EQ(stats.slabs, 2u);
+    ASSERT_EQ(stats.capacity, 128u);
+    ASSERT_EQ(stats.used, 100u);
+    ASSERT_EQ(loop->slabStats<uvw::IdleHandle>().capacity, 0u);
+
+    for(auto &&timer: timers) {
+        timer->close();
+    }
+
+    heap->close();
+    timers.clear();
+    loop->run();
+
+    stats = loop->slabStats<uvw::TimerHandle>();
+
+    ASSERT_EQ(stats.used, 0u);
+    ASSERT_EQ(stats.capacity, 128u);
+
+    auto timer = loop->resource<uvw::TimerHandle>();
+
+    ASSERT_EQ(loop->slabStats<uvw::TimerHandle>().used, 1u);
+    ASSERT_EQ(loop->slabStats<uvw::TimerHandle>().slabs, 2u);
+
+    timer->close();
+    timer.reset();
+    loop->run();
+    loop->close();
+}
+
+
+TEST(SlabPool, OutliveLoop) {
+    auto loop = uvw::Loop::create();
+    bool closed = false;
+
+    loop->slabs(true);
+
+    auto handle = loop->resource<uvw::IdleHandle>();
+
+    handle->on<uvw::CloseEvent>([&closed](const auto &, auto &) { closed = true; });
+    handle->close();
+    loop->run();
+    loop->close();
+
+    ASSERT_TRUE(closed);
+    ASSERT_EQ(loop->slabStats<uvw::IdleHandle>().capacity, 0u);
+
+    // the last handle releases the slabs of the loop
+    loop.reset();
+    handle.reset();
+}
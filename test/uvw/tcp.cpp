@@ -59,6 +59,599 @@ TEST(TCP, ReadWrite) {
 }
 
 
+TEST(TCP, Echo) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::TCPHandle>();
+    auto client = loop->resource<uvw::TCPHandle>();
+    std::size_t echoed = 0u;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::ListenEvent>([](const uvw::ListenEvent &, uvw::TCPHandle &handle) {
+        auto socket = handle.loop().resource<uvw::TCPHandle>();
+
+        socket->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+        socket->on<uvw::CloseEvent>([&handle](const auto &, auto &) { handle.close(); });
+        socket->on<uvw::EndEvent>([](const auto &, auto &sock) { sock.close(); });
+
+        socket->on<uvw::DataEvent>([](uvw::DataEvent &event, uvw::TCPHandle &sock) {
+            // pooled buffers are written back as they are
+            ASSERT_EQ(sock.tryWrite(std::move(event.data), event.length), static_cast<int>(event.length));
+        });
+
+        handle.accept(*socket);
+        socket->read();
+    });
+
+    client->on<uvw::DataEvent>([&echoed](const uvw::DataEvent &event, uvw::TCPHandle &handle) {
+        if((echoed += event.length) == 3u) {
+            handle.close();
+        }
+    });
+
+    client->once<uvw::ConnectEvent>([](const uvw::ConnectEvent &, uvw::TCPHandle &handle) {
+        handle.read();
+        handle.write(std::unique_ptr<char[]>(new char[3]{'a', 'b', 'c'}), 3);
+    });
+
+    server->bind(address, port);
+    server->listen();
+    client->connect(address, port);
+
+    loop->run();
+
+    ASSERT_EQ(echoed, 3u);
+}
+
+
+TEST(TCP, WriteRecycle) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+    const std::size_t count = 100u;
+
+    static std::size_t released{};
+    released = 0u;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::TCPHandle>();
+    auto client = loop->resource<uvw::TCPHandle>();
+
+    std::size_t written = 0u;
+    std::size_t received = 0u;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::ListenEvent>([&received](const uvw::ListenEvent &, uvw::TCPHandle &handle) {
+        std::shared_ptr<uvw::TCPHandle> socket = handle.loop().resource<uvw::TCPHandle>();
+
+        socket->on<uvw::ErrorEvent>([](const uvw::ErrorEvent &, uvw::TCPHandle &) { FAIL(); });
+        socket->on<uvw::CloseEvent>([&handle](const uvw::CloseEvent &, uvw::TCPHandle &) { handle.close(); });
+        socket->on<uvw::EndEvent>([](const uvw::EndEvent &, uvw::TCPHandle &sock) { sock.close(); });
+        socket->on<uvw::DataEvent>([&received](const uvw::DataEvent &event, uvw::TCPHandle &) { received += event.length; });
+
+        handle.accept(*socket);
+        socket->read();
+    });
+
+    auto write = [](uvw::TCPHandle &handle) {
+        auto data = std::unique_ptr<char[], void(*)(char *)>{new char[1]{ 'a' }, [](char *ptr) { ++released; delete[] ptr; }};
+        handle.write(std::move(data), 1u);
+    };
+
+    client->on<uvw::WriteEvent>([&](const uvw::WriteEvent &, uvw::TCPHandle &handle) {
+        // requests are reused, their data are released as soon as they complete, not on reuse
+        ASSERT_EQ(released, written++);
+
+        if(written == count) {
+            handle.close();
+        } else {
+            write(handle);
+        }
+    });
+
+    client->once<uvw::ConnectEvent>([&write](const uvw::ConnectEvent &, uvw::TCPHandle &handle) {
+        write(handle);
+    });
+
+    server->bind(address, port);
+    server->listen();
+    client->connect(address, port);
+
+    loop->run();
+
+    ASSERT_EQ(written, count);
+    ASSERT_EQ(released, count);
+    ASSERT_EQ(received, count);
+}
+
+
+TEST(TCP, Writev) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::TCPHandle>();
+    auto client = loop->resource<uvw::TCPHandle>();
+
+    std::string received{};
+    std::size_t writes = 0u;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::ListenEvent>([&received](const uvw::ListenEvent &, uvw::TCPHandle &handle) {
+        std::shared_ptr<uvw::TCPHandle> socket = handle.loop().resource<uvw::TCPHandle>();
+
+        socket->on<uvw::ErrorEvent>([](const uvw::ErrorEvent &, uvw::TCPHandle &) { FAIL(); });
+        socket->on<uvw::CloseEvent>([&handle](const uvw::CloseEvent &, uvw::TCPHandle &) { handle.close(); });
+        socket->on<uvw::EndEvent>([](const uvw::EndEvent &, uvw::TCPHandle &sock) { sock.close(); });
+
+        socket->on<uvw::DataEvent>([&received](const uvw::DataEvent &event, uvw::TCPHandle &) {
+            received.append(event.data.get(), event.length);
+        });
+
+        handle.accept(*socket);
+        socket->read();
+    });
+
+    client->on<uvw::WriteEvent>([&writes](const uvw::WriteEvent &, uvw::TCPHandle &handle) {
+        handle.close();
+        ++writes;
+    });
+
+    client->once<uvw::ConnectEvent>([](const uvw::ConnectEvent &, uvw::TCPHandle &handle) {
+        char header[] = { 'a', 'b' };
+        std::vector<uvw::Buffer> head{};
+        std::vector<uvw::Buffer> bufs{};
+
+        head.emplace_back(header, 1u);
+        head.emplace_back(header + 1u, 1u);
+        bufs.emplace_back(std::unique_ptr<char[]>(new char[2]{ 'c', 'd' }), 2u);
+        bufs.emplace_back(std::unique_ptr<char[]>(new char[1]{ 'e' }), 1u);
+
+        ASSERT_EQ(handle.tryWrite(head), 2);
+
+        handle.write(std::move(bufs));
+    });
+
+    server->bind(address, port);
+    server->listen();
+    client->connect(address, port);
+
+    loop->run();
+
+    ASSERT_EQ(received, "abcde");
+    ASSERT_EQ(writes, 1u);
+}
+
+
+TEST(TCP, Cork) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::TCPHandle>();
+    auto client = loop->resource<uvw::TCPHandle>();
+
+    std::string received{};
+    std::size_t writes = 0u;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::ListenEvent>([&received](const uvw::ListenEvent &, uvw::TCPHandle &handle) {
+        std::shared_ptr<uvw::TCPHandle> socket = handle.loop().resource<uvw::TCPHandle>();
+
+        socket->on<uvw::ErrorEvent>([](const uvw::ErrorEvent &, uvw::TCPHandle &) { FAIL(); });
+        socket->on<uvw::CloseEvent>([&handle](const uvw::CloseEvent &, uvw::TCPHandle &) { handle.close(); });
+        socket->on<uvw::EndEvent>([](const uvw::EndEvent &, uvw::TCPHandle &sock) { sock.close(); });
+
+        socket->on<uvw::DataEvent>([&received](const uvw::DataEvent &event, uvw::TCPHandle &) {
+            received.append(event.data.get(), event.length);
+        });
+
+        handle.accept(*socket);
+        socket->read();
+    });
+
+    client->on<uvw::WriteEvent>([&writes](const uvw::WriteEvent &, uvw::TCPHandle &handle) {
+        if(++writes == 5u) {
+            ASSERT_TRUE(handle.corked());
+            handle.uncork();
+            ASSERT_FALSE(handle.corked());
+            handle.close();
+        }
+    });
+
+    client->once<uvw::ConnectEvent>([&writes](const uvw::ConnectEvent &, uvw::TCPHandle &handle) {
+        static char data[] = { 'a', 'b' };
+        std::vector<uvw::Buffer> bufs{};
+
+        bufs.emplace_back(std::unique_ptr<char[]>(new char[1]{ 'd' }), 1u);
+        bufs.emplace_back(std::unique_ptr<char[]>(new char[1]{ 'e' }), 1u);
+
+        ASSERT_FALSE(handle.corked());
+
+        handle.cork();
+
+        ASSERT_TRUE(handle.corked());
+
+        handle.write(data, 2);
+        handle.write(std::unique_ptr<char[]>(new char[1]{ 'c' }), 1);
+        handle.write(std::move(bufs));
+
+        ASSERT_EQ(writes, 0u);
+
+        // the threshold is reached, everything is flushed at once
+        handle.cork(2u);
+        handle.write(std::unique_ptr<char[]>(new char[2]{ 'f', 'g' }), 2);
+        handle.write(std::unique_ptr<char[]>(new char[1]{ 'h' }), 1);
+    });
+
+    server->bind(address, port);
+    server->listen();
+    client->connect(address, port);
+
+    loop->run();
+
+    ASSERT_EQ(received, "abcdefgh");
+    ASSERT_EQ(writes, 5u);
+}
+
+
+TEST(TCP, WaterMarks) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::TCPHandle>();
+    auto client = loop->resource<uvw::TCPHandle>();
+
+    bool checkPressureEvent = false;
+    bool checkDrainEvent = false;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::ListenEvent>([](const uvw::ListenEvent &, uvw::TCPHandle &handle) {
+        std::shared_ptr<uvw::TCPHandle> socket = handle.loop().resource<uvw::TCPHandle>();
+
+        socket->on<uvw::ErrorEvent>([](const uvw::ErrorEvent &, uvw::TCPHandle &) { FAIL(); });
+        socket->on<uvw::CloseEvent>([&handle](const uvw::CloseEvent &, uvw::TCPHandle &) { handle.close(); });
+        socket->on<uvw::EndEvent>([](const uvw::EndEvent &, uvw::TCPHandle &sock) { sock.close(); });
+
+        handle.accept(*socket);
+        socket->read();
+    });
+
+    client->on<uvw::PressureEvent>([&checkPressureEvent](const uvw::PressureEvent &, uvw::TCPHandle &handle) {
+        ASSERT_FALSE(checkPressureEvent);
+        ASSERT_TRUE(handle.pressured());
+        checkPressureEvent = true;
+    });
+
+    client->on<uvw::DrainEvent>([&checkDrainEvent](const uvw::DrainEvent &, uvw::TCPHandle &handle) {
+        ASSERT_FALSE(checkDrainEvent);
+        ASSERT_FALSE(handle.pressured());
+        checkDrainEvent = true;
+        handle.close();
+    });
+
+    client->once<uvw::ConnectEvent>([](const uvw::ConnectEvent &, uvw::TCPHandle &handle) {
+        handle.waterMarks(2u, 0u);
+
+        ASSERT_EQ(handle.waterMarks().first, 2u);
+        ASSERT_EQ(handle.waterMarks().second, 0u);
+
+        // corked data count as queued data
+        handle.cork();
+        handle.write(std::unique_ptr<char[]>(new char[1]{ 'a' }), 1);
+
+        ASSERT_FALSE(handle.pressured());
+
+        handle.write(std::unique_ptr<char[]>(new char[1]{ 'b' }), 1);
+
+        ASSERT_TRUE(handle.pressured());
+    });
+
+    server->bind(address, port);
+    server->listen();
+    client->connect(address, port);
+
+    loop->run();
+
+    ASSERT_TRUE(checkPressureEvent);
+    ASSERT_TRUE(checkDrainEvent);
+}
+
+
+TEST(TCP, Pipe) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::TCPHandle>();
+    auto client = loop->resource<uvw::TCPHandle>();
+
+    std::string received{};
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::ListenEvent>([](const uvw::ListenEvent &, uvw::TCPHandle &handle) {
+        std::shared_ptr<uvw::TCPHandle> socket = handle.loop().resource<uvw::TCPHandle>();
+
+        socket->on<uvw::ErrorEvent>([](const uvw::ErrorEvent &, uvw::TCPHandle &) { FAIL(); });
+        socket->on<uvw::CloseEvent>([&handle](const uvw::CloseEvent &, uvw::TCPHandle &) { handle.close(); });
+        socket->on<uvw::ShutdownEvent>([](const uvw::ShutdownEvent &, uvw::TCPHandle &sock) { sock.close(); });
+
+        handle.accept(*socket);
+
+        // echo server
+        socket->pipe(*socket);
+
+        ASSERT_NE(socket->waterMarks().first, 0u);
+    });
+
+    client->on<uvw::DataEvent>([&received](const uvw::DataEvent &event, uvw::TCPHandle &handle) {
+        received.append(event.data.get(), event.length);
+
+        if(received.size() == 3u) {
+            handle.shutdown();
+        }
+    });
+
+    client->on<uvw::EndEvent>([](const uvw::EndEvent &, uvw::TCPHandle &handle) {
+        handle.close();
+    });
+
+    client->once<uvw::ConnectEvent>([](const uvw::ConnectEvent &, uvw::TCPHandle &handle) {
+        handle.read();
+        handle.write(std::unique_ptr<char[]>(new char[3]{ 'a', 'b', 'c' }), 3);
+    });
+
+    server->bind(address, port);
+    server->listen();
+    client->connect(address, port);
+
+    loop->run();
+
+    ASSERT_EQ(received, "abc");
+}
+
+
+TEST(TCP, Relay) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::TCPHandle>();
+    auto client = loop->resource<uvw::TCPHandle>();
+
+    std::shared_ptr<const uvw::RelayInfo> stale{};
+    std::shared_ptr<const uvw::RelayInfo> info{};
+    std::string received{};
+    bool checkListeners = false;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::ListenEvent>([&](const uvw::ListenEvent &, uvw::TCPHandle &handle) {
+        std::shared_ptr<uvw::TCPHandle> socket = handle.loop().resource<uvw::TCPHandle>();
+
+        socket->on<uvw::ErrorEvent>([](const uvw::ErrorEvent &, uvw::TCPHandle &) { FAIL(); });
+        socket->on<uvw::CloseEvent>([&handle](const uvw::CloseEvent &, uvw::TCPHandle &) { handle.close(); });
+
+        socket->on<uvw::ShutdownEvent>([&checkListeners](const uvw::ShutdownEvent &, uvw::TCPHandle &sock) {
+            // the relay is gone along with its listeners
+            checkListeners = sock.empty<uvw::DataEvent>() && sock.empty<uvw::EndEvent>() && sock.empty<uvw::PressureEvent>() && sock.empty<uvw::DrainEvent>();
+            sock.close();
+        });
+
+        handle.accept(*socket);
+
+        // setting up the relay again replaces the first one
+        stale = socket->relayTo(*socket);
+        info = socket->relayTo(*socket);
+    });
+
+    client->on<uvw::DataEvent>([&received](const uvw::DataEvent &event, uvw::TCPHandle &handle) {
+        received.append(event.data.get(), event.length);
+
+        if(received.size() == 4u) {
+            handle.shutdown();
+        }
+    });
+
+    client->on<uvw::EndEvent>([](const uvw::EndEvent &, uvw::TCPHandle &handle) {
+        handle.close();
+    });
+
+    client->once<uvw::ConnectEvent>([](const uvw::ConnectEvent &, uvw::TCPHandle &handle) {
+        handle.read();
+        handle.write(std::unique_ptr<char[]>(new char[4]{ 'a', 'b', 'c', 'd' }), 4);
+    });
+
+    server->bind(address, port);
+    server->listen();
+    client->connect(address, port);
+
+    loop->run();
+
+    ASSERT_EQ(received, "abcd");
+    ASSERT_TRUE(checkListeners);
+    ASSERT_EQ(stale->bytes, 0u);
+    ASSERT_NE(info, nullptr);
+    ASSERT_EQ(info->bytes, 4u);
+    ASSERT_GE(info->chunks, 1u);
+    ASSERT_EQ(info->pauses, 0u);
+}
+
+
+TEST(TCP, Allocator) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::TCPHandle>();
+    auto client = loop->resource<uvw::TCPHandle>();
+
+    std::size_t allocated = 0u;
+    std::size_t released = 0u;
+    std::size_t received = 0u;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::ListenEvent>([&](const uvw::ListenEvent &, uvw::TCPHandle &handle) {
+        std::shared_ptr<uvw::TCPHandle> socket = handle.loop().resource<uvw::TCPHandle>();
+
+        socket->on<uvw::ErrorEvent>([](const uvw::ErrorEvent &, uvw::TCPHandle &) { FAIL(); });
+        socket->on<uvw::CloseEvent>([&handle](const uvw::CloseEvent &, uvw::TCPHandle &) { handle.close(); });
+        socket->on<uvw::EndEvent>([](const uvw::EndEvent &, uvw::TCPHandle &sock) { sock.close(); });
+
+        socket->on<uvw::DataEvent>([&received](const uvw::DataEvent &event, uvw::TCPHandle &) {
+            ASSERT_LE(event.length, 4u);
+            received += event.length;
+        });
+
+        socket->allocator([&](std::size_t &size) {
+            ++allocated;
+            size = 4u;
+            return std::unique_ptr<char[], uvw::BufferDeleter>{new char[4], uvw::BufferDeleter{[](char *ptr, void *payload) noexcept {
+                ++*static_cast<std::size_t *>(payload);
+                delete[] ptr;
+            }, &released}};
+        });
+
+        handle.accept(*socket);
+        socket->read();
+    });
+
+    client->once<uvw::WriteEvent>([](const uvw::WriteEvent &, uvw::TCPHandle &handle) {
+        handle.close();
+    });
+
+    client->once<uvw::ConnectEvent>([](const uvw::ConnectEvent &, uvw::TCPHandle &handle) {
+        auto data = std::unique_ptr<char[]>(new char[10]{ 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j' });
+        handle.write(std::move(data), 10);
+    });
+
+    server->bind(address, port);
+    server->listen();
+    client->connect(address, port);
+
+    loop->run();
+
+    ASSERT_EQ(received, 10u);
+    ASSERT_GE(allocated, 3u);
+    ASSERT_EQ(allocated, released);
+}
+
+
+TEST(TCP, BatchAccept) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+    const std::size_t count = 8u;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::TCPHandle>();
+
+    std::size_t accepted = 0u;
+    std::size_t batches = 0u;
+    std::size_t closed = 0u;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    server->on<uvw::ListenEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->on<uvw::AcceptEvent<uvw::TCPHandle>>([&](const uvw::AcceptEvent<uvw::TCPHandle> &event, uvw::TCPHandle &handle) {
+        ASSERT_FALSE(event.handles.empty());
+        ASSERT_LE(event.handles.size(), 4u);
+
+        for(auto &&socket: event.handles) {
+            ASSERT_TRUE(socket->readable());
+            socket->close();
+        }
+
+        ++batches;
+
+        if((accepted += event.handles.size()) == count) {
+            handle.batchAccept(0u);
+            handle.close();
+        }
+    });
+
+    server->batchAccept(4u);
+    server->bind(address, port);
+    server->listen();
+
+    for(auto pos = 0u; pos < count; ++pos) {
+        auto client = loop->resource<uvw::TCPHandle>();
+
+        client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+        client->on<uvw::ConnectEvent>([](const uvw::ConnectEvent &, uvw::TCPHandle &handle) { handle.read(); });
+        client->on<uvw::EndEvent>([](const uvw::EndEvent &, uvw::TCPHandle &handle) { handle.close(); });
+        client->on<uvw::CloseEvent>([&closed](const uvw::CloseEvent &, uvw::TCPHandle &) { ++closed; });
+
+        client->connect(address, port);
+    }
+
+    loop->run();
+
+    ASSERT_EQ(accepted, count);
+    ASSERT_GE(batches, 2u);
+    ASSERT_EQ(closed, count);
+}
+
+
+TEST(TCP, BatchAcceptClose) {
+    auto loop = uvw::Loop::create();
+    auto server = loop->resource<uvw::TCPHandle>();
+    bool checkErrorEvent = false;
+
+    loop->on<uvw::ErrorEvent>([&checkErrorEvent](const auto &, auto &) { checkErrorEvent = true; });
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->batchAccept(4u);
+    server->bind("127.0.0.1", 4242);
+    server->listen();
+
+    // the server outlives its close, the spare handles mustn't
+    server->close();
+    loop->run();
+    loop->close();
+
+    ASSERT_FALSE(checkErrorEvent);
+}
+
+
+TEST(TCP, CorkClose) {
+    auto loop = uvw::Loop::create();
+    auto handle = loop->resource<uvw::TCPHandle>();
+    bool checkErrorEvent = false;
+
+    loop->on<uvw::ErrorEvent>([&checkErrorEvent](const auto &, auto &) { checkErrorEvent = true; });
+    handle->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    handle->cork();
+
+    // the handle outlives its close, the hook used to flush it mustn't
+    handle->close();
+    loop->run();
+
+    ASSERT_FALSE(handle->corked());
+
+    loop->close();
+
+    ASSERT_FALSE(checkErrorEvent);
+}
+
+
 TEST(TCP, SockPeer) {
     const std::string address = std::string{"127.0.0.1"};
     const unsigned int port = 4242;
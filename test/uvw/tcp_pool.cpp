@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <uvw/tcp_pool.h>
+
+
+TEST(TCPConnectionPool, Functionalities) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::TCPHandle>();
+    auto pool = uvw::TCPConnectionPool::create(loop);
+
+    std::shared_ptr<uvw::TCPHandle> first{};
+    bool refused = false;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::ListenEvent>([](const uvw::ListenEvent &, uvw::TCPHandle &handle) {
+        auto socket = handle.loop().resource<uvw::TCPHandle>();
+        handle.accept(*socket);
+        // the idle connection is discarded as soon as the peer goes away
+        socket->close();
+        handle.close();
+    });
+
+    server->bind(address, port);
+    server->listen();
+
+    pool->checkout(address, port, [&](const uvw::ErrorEvent &event, std::shared_ptr<uvw::TCPHandle> handle) {
+        ASSERT_FALSE(event);
+        ASSERT_NE(handle, nullptr);
+
+        first = handle;
+
+        handle->on<uvw::DataEvent>([](const auto &, auto &) { FAIL(); });
+        handle->on<uvw::CloseEvent>([](const auto &, auto &) {});
+
+        ASSERT_TRUE(pool->checkin(handle));
+        ASSERT_FALSE(pool->checkin(handle));
+        ASSERT_EQ(pool->stats().idle, 1u);
+
+        pool->checkout(address, port, [&](const uvw::ErrorEvent &other, std::shared_ptr<uvw::TCPHandle> conn) {
+            ASSERT_FALSE(other);
+            ASSERT_EQ(conn, first);
+
+            // the next borrower doesn't get the traffic of the previous one
+            ASSERT_TRUE(conn->empty<uvw::DataEvent>());
+            ASSERT_TRUE(conn->empty<uvw::ErrorEvent>());
+            ASSERT_FALSE(conn->empty<uvw::CloseEvent>());
+
+            ASSERT_TRUE(pool->checkin(conn));
+        });
+    });
+
+    pool->checkout(address, port + 1, [&refused](const uvw::ErrorEvent &event, std::shared_ptr<uvw::TCPHandle> handle) {
+        ASSERT_TRUE(event);
+        ASSERT_EQ(handle, nullptr);
+        refused = true;
+    });
+
+    auto other = loop->resource<uvw::TCPHandle>();
+
+    ASSERT_FALSE(pool->checkin(other));
+    ASSERT_FALSE(pool->checkin(nullptr));
+
+    other->close();
+    loop->run();
+
+    ASSERT_TRUE(refused);
+    ASSERT_EQ(pool->stats().hits, 1u);
+    ASSERT_EQ(pool->stats().misses, 2u);
+    ASSERT_EQ(pool->stats().discarded, 1u);
+    ASSERT_EQ(pool->stats().idle, 0u);
+    ASSERT_DOUBLE_EQ(pool->hitRate(), 1. / 3.);
+}
+
+
+TEST(TCPConnectionPool, IdleTimeout) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::TCPHandle>();
+    auto pool = uvw::TCPConnectionPool::create(loop);
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::ListenEvent>([](const uvw::ListenEvent &, uvw::TCPHandle &handle) {
+        auto socket = handle.loop().resource<uvw::TCPHandle>();
+
+        socket->on<uvw::EndEvent>([](const uvw::EndEvent &, uvw::TCPHandle &sock) { sock.close(); });
+
+        handle.accept(*socket);
+        socket->read();
+        handle.close();
+    });
+
+    server->bind(address, port);
+    server->listen();
+
+    pool->idleTimeout(uvw::TCPConnectionPool::Time{10});
+    pool->maxIdle(1u);
+
+    bool checkCloseEvent = false;
+
+    pool->checkout(address, port, [&pool, &checkCloseEvent](const uvw::ErrorEvent &event, std::shared_ptr<uvw::TCPHandle> handle) {
+        ASSERT_FALSE(event);
+
+        // close listeners of the user survive the check-in
+        handle->on<uvw::CloseEvent>([&checkCloseEvent](const auto &, auto &) { checkCloseEvent = true; });
+
+        ASSERT_TRUE(pool->checkin(handle));
+    });
+
+    loop->run();
+
+    ASSERT_TRUE(checkCloseEvent);
+    ASSERT_EQ(pool->stats().misses, 1u);
+    ASSERT_EQ(pool->stats().reaped, 1u);
+    ASSERT_EQ(pool->stats().idle, 0u);
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <uvw/udp.h>
 
@@ -104,6 +105,300 @@ TEST(UDP, ReadSend) {
 }
 
 
+TEST(UDP, Echo) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::UDPHandle>();
+    auto client = loop->resource<uvw::UDPHandle>();
+    std::size_t echoed = 0u;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->on<uvw::UDPDataEvent>([](uvw::UDPDataEvent &event, uvw::UDPHandle &handle) {
+        // pooled buffers are sent back as they are
+        if(event.data[0] == 'a') {
+            ASSERT_EQ(handle.trySend(event.sender, std::move(event.data), event.length), 2);
+        } else {
+            handle.send(event.sender, std::move(event.data), event.length);
+        }
+    });
+
+    client->on<uvw::UDPDataEvent>([&](const uvw::UDPDataEvent &event, uvw::UDPHandle &handle) {
+        ASSERT_EQ(event.length, 2u);
+
+        if(++echoed == 2u) {
+            server->close();
+            handle.close();
+        }
+    });
+
+    server->bind(address, port);
+    server->recv();
+    client->bind(address, port + 1);
+    client->recv();
+
+    client->send(uvw::Addr{address, port}, std::unique_ptr<char[]>(new char[2]{'a', 'b'}), 2);
+    client->send(uvw::Addr{address, port}, std::unique_ptr<char[]>(new char[2]{'c', 'd'}), 2);
+
+    loop->run();
+
+    ASSERT_EQ(echoed, 2u);
+}
+
+
+TEST(UDP, Allocator) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::UDPHandle>();
+    auto client = loop->resource<uvw::UDPHandle>();
+
+    bool empty = true;
+    bool checkErrorEvent = false;
+
+    server->on<uvw::ErrorEvent>([&checkErrorEvent](const uvw::ErrorEvent &event, uvw::UDPHandle &handle) {
+        ASSERT_EQ(event.code(), UV_ENOBUFS);
+        checkErrorEvent = true;
+        handle.allocator(nullptr);
+    });
+
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->once<uvw::UDPDataEvent>([&client, &empty](const uvw::UDPDataEvent &event, uvw::UDPHandle &handle) {
+        ASSERT_FALSE(empty);
+        ASSERT_EQ(event.length, 2u);
+        client->close();
+        handle.close();
+    });
+
+    server->allocator([&empty](std::size_t &size) {
+        std::unique_ptr<char[], uvw::BufferDeleter> data{};
+
+        if(!std::exchange(empty, false)) {
+            data.reset(new char[size]);
+        }
+
+        return data;
+    });
+
+    server->bind(address, port);
+    server->recv();
+
+    auto data = std::unique_ptr<char[]>(new char[2]{ 'b', 'c' });
+    client->trySend(uvw::Addr{address, port}, std::move(data), 2);
+
+    loop->run();
+
+    ASSERT_TRUE(checkErrorEvent);
+}
+
+
+TEST(UDP, RecvMmsg) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+    const std::size_t count = 10u;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::UDPHandle>(UV_UDP_RECVMMSG);
+    auto client = loop->resource<uvw::UDPHandle>();
+
+    std::size_t received = 0u;
+    std::size_t batches = 0u;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->on<uvw::UDPDataEvent>([&](const uvw::UDPDataEvent &, uvw::UDPHandle &handle) {
+        // platforms without recvmmsg fall back to a datagram at a time
+        if(++received == count) {
+            client->close();
+            handle.close();
+        }
+    });
+
+    server->on<uvw::UDPBatchDataEvent>([&](const uvw::UDPBatchDataEvent &event, uvw::UDPHandle &handle) {
+        ASSERT_NE(event.size(), 0u);
+        ++batches;
+
+        for(auto &&datagram: event) {
+            ASSERT_EQ(datagram.sender.ip(), address);
+            ASSERT_EQ(datagram.data, std::string_view{"abc"});
+            ASSERT_FALSE(datagram.partial);
+            ++received;
+        }
+
+        if(received == count) {
+            client->close();
+            handle.close();
+        }
+    });
+
+    server->bind(uvw::Addr{ address, port });
+    server->recv();
+
+    for(auto pos = 0u; pos < count; ++pos) {
+        char data[] = { 'a', 'b', 'c' };
+        ASSERT_EQ(client->trySend(address, port, data, 3u), 3);
+    }
+
+    loop->run();
+
+    ASSERT_EQ(received, count);
+    ASSERT_LE(batches, count);
+}
+
+
+TEST(UDP, SendBatch) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+    const std::size_t count = 50u;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::UDPHandle>();
+    auto client = loop->resource<uvw::UDPHandle>();
+
+    std::size_t received = 0u;
+    std::size_t batches = 0u;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->on<uvw::UDPDataEvent>([&](const uvw::UDPDataEvent &event, uvw::UDPHandle &handle) {
+        ASSERT_EQ(event.length, 3u);
+
+        if(++received == 2u * count) {
+            client->close();
+            handle.close();
+        }
+    });
+
+    client->on<uvw::SendBatchEvent>([&](const uvw::SendBatchEvent &event, uvw::UDPHandle &) {
+        ASSERT_EQ(event.sent, count);
+        ASSERT_EQ(event.failed, 0u);
+        ASSERT_EQ(event.error, 0);
+        ++batches;
+    });
+
+    server->bind(uvw::Addr{ address, port });
+    server->recv();
+
+    auto batch = [&]() {
+        std::vector<std::pair<uvw::Addr, uvw::Buffer>> datagrams;
+
+        for(auto pos = 0u; pos < count; ++pos) {
+            auto data = std::make_unique<char[]>(3u);
+            std::copy_n("abc", 3u, data.get());
+            datagrams.emplace_back(uvw::Addr{ address, port }, uvw::Buffer{std::move(data), 3u});
+        }
+
+        return datagrams;
+    };
+
+    // the first batch binds the socket, the second one finds it ready
+    client->sendBatch(batch());
+    client->sendBatch(batch());
+
+    loop->run();
+
+    ASSERT_EQ(batches, 2u);
+    ASSERT_EQ(received, 2u * count);
+}
+
+
+TEST(UDP, SegmentationOffload) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+    const unsigned int segment = 100u;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::UDPHandle>();
+    auto client = loop->resource<uvw::UDPHandle>();
+
+    std::size_t received = 0u;
+    int error = 0;
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([&error](const uvw::ErrorEvent &event, auto &) { error = event.code(); });
+
+    // the kernel can either coalesce the segments or not, both are fine
+    server->on<uvw::UDPDataEvent>([&](const uvw::UDPDataEvent &event, uvw::UDPHandle &handle) {
+        // coalesced packets aren't split, the boundaries of the segments aren't known
+        if((received += event.length) == 350u) {
+            client->close();
+            handle.close();
+        }
+    });
+
+    ASSERT_FALSE(server->gro(true));
+    ASSERT_FALSE(client->gso(segment));
+
+    server->bind(uvw::Addr{ address, port });
+    client->bind(uvw::Addr{ address, port + 1u });
+
+    if(!server->gro(true) || !client->gso(segment)) {
+        // not supported by the platform or the kernel
+        client->close();
+        server->close();
+        loop->run();
+        GTEST_SKIP();
+    }
+
+    ASSERT_TRUE(client->gso(0u));
+
+    server->recv();
+
+    char data[350u]{};
+
+    // segments larger than 64 KiB aren't truncated
+    ASSERT_EQ(client->trySend(address, port, data, 350u, 65536u), 0);
+    ASSERT_EQ(error, UV_EINVAL);
+
+    ASSERT_EQ(client->trySend(address, port, data, 350u, segment), 350);
+
+    loop->run();
+
+    ASSERT_EQ(received, 350u);
+}
+
+
+TEST(UDP, SockAddr) {
+    const std::string address = std::string{"127.0.0.1"};
+    const unsigned int port = 4242;
+
+    auto loop = uvw::Loop::getDefault();
+    auto server = loop->resource<uvw::UDPHandle>();
+    auto client = loop->resource<uvw::UDPHandle>();
+
+    const auto addr = uvw::SockAddr::parse(address, port);
+    const auto local = uvw::SockAddr::parse(address, port + 1u);
+
+    server->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+    client->on<uvw::ErrorEvent>([](const auto &, auto &) { FAIL(); });
+
+    server->on<uvw::UDPDataEvent>([&](const uvw::UDPDataEvent &event, uvw::UDPHandle &handle) {
+        ASSERT_EQ(event.sender, local);
+        ASSERT_EQ(event.sender.ip(), address);
+        ASSERT_EQ(event.sender.port(), port + 1u);
+
+        client->close();
+        handle.close();
+    });
+
+    server->bind(addr);
+    client->bind(local);
+    server->recv();
+
+    char data[] = { 'a', 'b', 'c' };
+    client->send(addr, data, 3u);
+
+    loop->run();
+}
+
+
 TEST(UDP, Sock) {
     const std::string address = std::string{"127.0.0.1"};
     const unsigned int port = 4242;
@@ -1,5 +1,7 @@
 #include <memory>
 #include <cstdlib>
+#include <type_traits>
+#include <unordered_set>
 #include <gtest/gtest.h>
 #include <uvw.hpp>
 
@@ -71,6 +73,59 @@ TEST(Util, ScopedFlags) {
 }
 
 
+TEST(Util, SockAddr) {
+    static_assert(std::is_trivially_copyable_v<uvw::SockAddr>);
+
+    sockaddr_in in4;
+    sockaddr_in6 in6;
+    uv_ip4_addr("127.0.0.1", 4242, &in4);
+    uv_ip6_addr("::1", 4242, &in6);
+
+    uvw::SockAddr empty{};
+    uvw::SockAddr v4{reinterpret_cast<const sockaddr &>(in4)};
+    uvw::SockAddr v6{reinterpret_cast<const sockaddr &>(in6)};
+
+    ASSERT_FALSE(empty);
+    ASSERT_EQ(empty.ip(), "");
+    ASSERT_EQ(empty.port(), 0u);
+
+    ASSERT_TRUE(v4);
+    ASSERT_EQ(v4.family(), AF_INET);
+    ASSERT_EQ(v4.ip(), "127.0.0.1");
+    ASSERT_EQ(v4.port(), 4242u);
+    ASSERT_EQ(v4.size(), sizeof(sockaddr_in));
+    ASSERT_EQ(v4.addr().ip, "127.0.0.1");
+
+    ASSERT_TRUE(v6);
+    ASSERT_EQ(v6.family(), AF_INET6);
+    ASSERT_EQ(v6.ip(), "::1");
+    ASSERT_EQ(v6.port(), 4242u);
+    ASSERT_EQ(v6.size(), sizeof(sockaddr_in6));
+
+    const sockaddr &raw = v4;
+    ASSERT_EQ(raw.sa_family, AF_INET);
+    ASSERT_EQ(uvw::SockAddr{raw}, v4);
+
+    in4.sin_port = htons(4243);
+    uvw::SockAddr other{reinterpret_cast<const sockaddr &>(in4)};
+
+    ASSERT_NE(v4, other);
+    ASSERT_LT(v4, other);
+    ASSERT_LT(v4, v6);
+    ASSERT_LT(empty, v4);
+
+    std::unordered_set<uvw::SockAddr> set{v4, v6, other, v4};
+    ASSERT_EQ(set.size(), 3u);
+    ASSERT_EQ(set.count(uvw::SockAddr{raw}), 1u);
+
+    ASSERT_EQ(uvw::SockAddr::parse("127.0.0.1", 4242), v4);
+    ASSERT_EQ(uvw::SockAddr::parse<uvw::IPv6>(uvw::Addr{"::1", 4242}), v6);
+    ASSERT_FALSE(uvw::SockAddr::parse("::1", 4242));
+    ASSERT_FALSE(uvw::SockAddr::parse("not an address", 4242));
+    ASSERT_FALSE(uvw::SockAddr::parse("127.0.0.1", 65536));
+}
+
+
 TEST(Util, Utilities) {
     ASSERT_EQ(uvw::PidType{}, uvw::PidType{});
 